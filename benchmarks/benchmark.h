@@ -0,0 +1,106 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <string_view>
+
+namespace floah::bench
+{
+    /**
+     * \brief Command line options shared by all benchmarks.
+     */
+    struct Options
+    {
+        /**
+         * \brief Font that covers at least printable ASCII.
+         */
+        std::filesystem::path font;
+
+        /**
+         * \brief Font that covers large CJK ranges. If empty, benchmarks that need many glyphs use font instead and
+         * mostly rasterize its missing glyph.
+         */
+        std::filesystem::path cjkFont;
+    };
+
+    /**
+     * \brief Results are added to this value, so that the compiler cannot remove the work that produced them.
+     */
+    inline volatile uint64_t sink = 0;
+
+    /**
+     * \brief Run a function repeatedly until it ran at least minRuns times and for at least half a second in total.
+     * \tparam F Function type.
+     * \param f Function.
+     * \param minRuns Minimum number of runs.
+     * \return Duration of the fastest run (in seconds).
+     */
+    template<typename F>
+    [[nodiscard]] double measure(F&& f, const uint32_t minRuns = 5)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const auto start = Clock::now();
+        auto       best  = std::numeric_limits<double>::max();
+        for (uint32_t runs = 0; runs < minRuns || Clock::now() - start < std::chrono::milliseconds(500); runs++)
+        {
+            const auto t0 = Clock::now();
+            f();
+            best = std::min(best, std::chrono::duration<double>(Clock::now() - t0).count());
+        }
+
+        return best;
+    }
+
+    /**
+     * \brief Print a result line.
+     * \param name Benchmark name.
+     * \param variant Variant, e.g. the implementation or input size.
+     * \param seconds Duration of one run (in seconds).
+     * \param items Number of items processed by one run.
+     * \param unit Name of the items.
+     */
+    void report(std::string_view name, std::string_view variant, double seconds, double items, std::string_view unit);
+
+    ////////////////////////////////////////////////////////////////
+    // Benchmarks.
+    ////////////////////////////////////////////////////////////////
+
+    /**
+     * \brief Compare FontMap::getCharacter with the std::unordered_map lookup it replaced, over typical UI labels.
+     * \param options Options.
+     */
+    void runFontMapLookup(const Options& options);
+
+    /**
+     * \brief Time FontMap::generateImageData for ranges of 100, 10k and 40k glyphs, on one and on all threads.
+     * \param options Options.
+     */
+    void runFontMapStartup(const Options& options);
+
+    /**
+     * \brief Compare Stylesheet::get through parent chains of several depths with FlattenedStylesheet::get.
+     * \param options Options.
+     */
+    void runStylesheetLookup(const Options& options);
+
+    /**
+     * \brief Time UTF-8 decoding and text emission for texts of 1k to 64k bytes, to show that cost grows linearly with
+     * length.
+     * \param options Options.
+     */
+    void runTextDecode(const Options& options);
+
+    /**
+     * \brief Compare the scalar and vectorized paths that write CompactVertex glyph quads.
+     * \param options Options.
+     */
+    void runTextQuads(const Options& options);
+}  // namespace floah::bench
@@ -0,0 +1,57 @@
+#include "benchmark.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <format>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/font_map.h"
+
+namespace floah::bench
+{
+    void runFontMapLookup(const Options& options)
+    {
+        FontMap fontMap(options.font, {32, 126}, {0, 24});
+        fontMap.generateImageData();
+
+        // Build labels like those of a data-heavy UI: short words, numbers and units.
+        constexpr std::array<std::string_view, 12> words = {
+          "File", "Edit", "Save as...", "Frame time", "Throughput", "Connected", "Latency", "Queue depth", "CPU", "GPU",
+          "Memory (MiB)", "Status: OK"};
+        std::vector<uint32_t> codes;
+        for (uint32_t i = 0; i < 2000; i++)
+        {
+            const auto label = std::format("{} {}.{:02} ms", words[i % words.size()], i * 37 % 10000, i % 100);
+            for (const auto c : label) codes.emplace_back(static_cast<uint8_t>(c));
+        }
+
+        // The lookup that the dense table replaced: one hash map probe per glyph.
+        std::unordered_map<uint32_t, FontMap::Character> map;
+        for (uint32_t c = 32; c <= 126; c++) map.emplace(c, fontMap.getCharacter(c));
+
+        const auto dense = measure([&] {
+            uint64_t sum = 0;
+            for (const auto c : codes) sum += fontMap.getCharacter(c).advance;
+            sink = sink + sum;
+        });
+        const auto hashed = measure([&] {
+            uint64_t sum = 0;
+            for (const auto c : codes) sum += map.find(c)->second.advance;
+            sink = sink + sum;
+        });
+
+        const auto count = static_cast<double>(codes.size());
+        report("font_map_lookup", "dense table", dense, count, "lookups");
+        report("font_map_lookup", "std::unordered_map", hashed, count, "lookups");
+    }
+}  // namespace floah::bench
@@ -0,0 +1,44 @@
+#include "benchmark.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <format>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/font_map.h"
+
+namespace floah::bench
+{
+    void runFontMapStartup(const Options& options)
+    {
+        // Start at CJK Unified Ideographs Extension A, so that large ranges stay mostly within CJK blocks.
+        constexpr uint32_t                first_code = 0x3400;
+        constexpr std::array<uint32_t, 3> counts     = {100, 10'000, 40'000};
+        const auto&                       font       = options.cjkFont.empty() ? options.font : options.cjkFont;
+
+        for (const auto count : counts)
+        {
+            for (const uint32_t threads : {1u, 0u})
+            {
+                // Every run needs a new FontMap, as image data is only generated once. Caching is disabled by default.
+                const auto seconds = measure(
+                  [&] {
+                      FontMap fontMap(font, {first_code, first_code + count - 1}, {0, 32});
+                      fontMap.setThreadCount(threads);
+                      fontMap.generateImageData();
+                      sink = sink + static_cast<uint64_t>(fontMap.getPackingEfficiency() * 1000.0f);
+                  },
+                  1);
+
+                const auto variant = std::format("{} glyphs, {}", count, threads ? "1 thread" : "all threads");
+                report("font_map_startup", variant, seconds, count, "glyphs");
+            }
+        }
+    }
+}  // namespace floah::bench
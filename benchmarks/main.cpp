@@ -0,0 +1,76 @@
+#include "benchmark.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <string>
+#include <utility>
+
+namespace
+{
+    using Benchmark = void (*)(const floah::bench::Options&);
+
+    /**
+     * \brief All benchmarks by name.
+     */
+    constexpr std::array<std::pair<std::string_view, Benchmark>, 5> benchmarks{{
+      {"font_map_lookup", &floah::bench::runFontMapLookup},
+      {"font_map_startup", &floah::bench::runFontMapStartup},
+      {"stylesheet_lookup", &floah::bench::runStylesheetLookup},
+      {"text_decode", &floah::bench::runTextDecode},
+      {"text_quads", &floah::bench::runTextQuads},
+    }};
+}  // namespace
+
+namespace floah::bench
+{
+    void report(const std::string_view name,
+                const std::string_view variant,
+                const double           seconds,
+                const double           items,
+                const std::string_view unit)
+    {
+        std::cout << std::format(
+          "{:<24} {:<32} {:>12.3f} ms {:>14.0f} {}/s\n", name, variant, seconds * 1000.0, items / seconds, unit);
+    }
+}  // namespace floah::bench
+
+int main(const int argc, char** argv)
+{
+    floah::bench::Options options;
+    std::string           filter;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--font" && i + 1 < argc)
+            options.font = argv[++i];
+        else if (arg == "--cjk-font" && i + 1 < argc)
+            options.cjkFont = argv[++i];
+        else
+            filter = arg;
+    }
+
+    if (options.font.empty())
+    {
+        std::cerr << "Usage: floah-viz-benchmarks --font <path> [--cjk-font <path>] [name filter]\n";
+        return 1;
+    }
+
+    try
+    {
+        for (const auto& [name, benchmark] : benchmarks)
+            if (name.find(filter) != std::string_view::npos) benchmark(options);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
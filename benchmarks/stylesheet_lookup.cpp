@@ -0,0 +1,78 @@
+#include "benchmark.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <format>
+#include <memory>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/stylesheet.h"
+
+namespace floah::bench
+{
+    void runStylesheetLookup(const Options&)
+    {
+        constexpr size_t                  property_count = 16;
+        constexpr std::array<uint32_t, 5> depths         = {1, 2, 4, 6, 8};
+        constexpr uint32_t                repeats        = 1000;
+
+        std::vector<PropertyId> floatIds, stringIds;
+        for (size_t i = 0; i < property_count; i++)
+        {
+            floatIds.emplace_back(std::format("float{}", i));
+            stringIds.emplace_back(std::format("string{}", i));
+        }
+
+        for (const auto depth : depths)
+        {
+            // All properties are set on the root, and each level below overrides one of them, like a theme hierarchy
+            // of app, theme, panel, widget class and widget.
+            std::vector<std::unique_ptr<Stylesheet>> chain;
+            for (uint32_t level = 0; level < depth; level++)
+            {
+                auto& sheet = *chain.emplace_back(std::make_unique<Stylesheet>());
+                if (level > 0) sheet.setParent(chain[level - 1].get());
+                for (size_t i = 0; i < property_count; i++)
+                {
+                    if (level != 0 && i != level % property_count) continue;
+                    sheet.set(floatIds[i], static_cast<float>(level * 100 + i));
+                    sheet.set(stringIds[i], std::format("level {} value {}", level, i));
+                }
+            }
+
+            const auto&         leaf = *chain.back();
+            FlattenedStylesheet flattened(leaf);
+
+            const auto chained = measure([&] {
+                uint64_t sum = 0;
+                for (uint32_t r = 0; r < repeats; r++)
+                {
+                    for (const auto id : floatIds) sum += static_cast<uint64_t>(*leaf.get<float>(id));
+                    for (const auto id : stringIds) sum += leaf.get<std::string>(id)->size();
+                }
+                sink = sink + sum;
+            });
+            const auto flat = measure([&] {
+                uint64_t sum = 0;
+                for (uint32_t r = 0; r < repeats; r++)
+                {
+                    for (const auto id : floatIds) sum += static_cast<uint64_t>(*flattened.get<float>(id));
+                    for (const auto id : stringIds) sum += flattened.get<std::string>(id)->size();
+                }
+                sink = sink + sum;
+            });
+
+            const auto lookups = static_cast<double>(repeats * property_count * 2);
+            report("stylesheet_lookup", std::format("depth {}, chained", depth), chained, lookups, "lookups");
+            report("stylesheet_lookup", std::format("depth {}, flattened", depth), flat, lookups, "lookups");
+        }
+    }
+}  // namespace floah::bench
@@ -0,0 +1,54 @@
+#include "benchmark.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <format>
+#include <span>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/font_map.h"
+#include "floah-viz/vertex.h"
+#include "floah-viz/generators/text_generator.h"
+
+namespace floah::bench
+{
+    void runTextDecode(const Options& options)
+    {
+        FontMap fontMap(options.font, {32, 255}, {0, 16});
+        fontMap.generateImageData();
+
+        // A log line with some 2-byte UTF-8 sequences, repeated to the requested length.
+        const std::string                 line   = "[12:04:51.337] worker-3: request r\xC3\xA9sum\xC3\xA9 took 17 ms; ";
+        constexpr std::array<uint32_t, 4> counts = {1024, 4096, 16384, 65536};
+
+        for (const auto count : counts)
+        {
+            TextGenerator generator;
+            while (generator.text.size() < count) generator.text += line;
+            generator.text.resize(count);
+
+            // Decode only. Throughput should not drop as the text gets longer.
+            const auto characters = static_cast<double>(generator.measure().vertexCount / 4);
+            const auto decode     = measure([&] { sink = sink + generator.measure().vertexCount; });
+
+            // Decode, layout and vertex emission.
+            std::vector<CompactVertex> vertices(generator.measure().vertexCount);
+            std::vector<uint32_t>      indices(generator.measure().indexCount);
+            const auto                 emit = measure([&] {
+                generator.emit(fontMap, std::span(vertices), std::span(indices), 0);
+                sink = sink + indices.back();
+            });
+
+            report("text_decode", std::format("{} bytes, decode", count), decode, characters, "chars");
+            report("text_decode", std::format("{} bytes, decode and emit", count), emit, characters, "chars");
+        }
+    }
+}  // namespace floah::bench
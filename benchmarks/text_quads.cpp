@@ -0,0 +1,64 @@
+#include "benchmark.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <format>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/font_map.h"
+#include "floah-viz/vertex.h"
+#include "generators/text_quads.h"
+
+namespace floah::bench
+{
+    void runTextQuads(const Options& options)
+    {
+        FontMap fontMap(options.font, {32, 255}, {0, 16});
+        fontMap.generateImageData();
+
+        constexpr std::array<uint32_t, 3> counts    = {64, 1024, 16384};
+        const auto                        ascender  = static_cast<float>(fontMap.getFontAscender());
+        constexpr float                   scale     = 1.5f;
+        constexpr float                   y         = 10.0f;
+        constexpr uint32_t                first     = 32;
+        constexpr uint32_t                charCount = 95;
+
+        for (const auto count : counts)
+        {
+            // Printable ASCII laid out on a single line.
+            std::vector<FontMap::Character> characters;
+            std::vector<float>              pens;
+            float                           pen = 0;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                characters.emplace_back(fontMap.getCharacter(first + i % charCount));
+                pens.emplace_back(pen);
+                pen += static_cast<float>(characters.back().advance) * scale;
+            }
+
+            std::vector<CompactVertex> vertices(static_cast<size_t>(count) * 4);
+            const auto                 scalar = measure([&] {
+                detail::writeQuadsScalar(characters.data(), pens.data(), count, y, ascender, scale, vertices.data());
+                sink = sink + vertices.back().uv[0];
+            });
+            const auto                 simd   = measure([&] {
+                detail::writeQuads(characters.data(), pens.data(), count, y, ascender, scale, vertices.data());
+                sink = sink + vertices.back().uv[0];
+            });
+
+            report("text_quads", std::format("{} glyphs, scalar", count), scalar, count, "glyphs");
+#if defined(__SSE2__)
+            report("text_quads", std::format("{} glyphs, sse2", count), simd, count, "glyphs");
+#else
+            report("text_quads", std::format("{} glyphs, default", count), simd, count, "glyphs");
+#endif
+        }
+    }
+}  // namespace floah::bench
@@ -0,0 +1,155 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <optional>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "math/include_all.h"
+
+namespace floah
+{
+    /**
+     * \brief Skyline bottom-left rectangle packer. Used to place glyphs in a FontMap image.
+     */
+    class AtlasPacker
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Result of packing a list of rectangles into the smallest image that fits.
+         */
+        struct Result
+        {
+            /**
+             * \brief Image size (in pixels).
+             */
+            math::uint2 imageSize;
+
+            /**
+             * \brief Position of the top-left corner of each rectangle, in the same order as the input.
+             */
+            std::vector<math::uint2> positions;
+
+            /**
+             * \brief Total rectangle area divided by image area.
+             */
+            float efficiency = 0;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        AtlasPacker();
+
+        /**
+         * \brief Construct a new, empty packer.
+         * \param imageSize Image size (in pixels).
+         * \param rectPadding Number of empty pixels to keep to the right of and below each rectangle.
+         */
+        AtlasPacker(math::uint2 imageSize, uint32_t rectPadding);
+
+        AtlasPacker(const AtlasPacker&);
+
+        AtlasPacker(AtlasPacker&&) noexcept;
+
+        ~AtlasPacker() noexcept;
+
+        AtlasPacker& operator=(const AtlasPacker&);
+
+        AtlasPacker& operator=(AtlasPacker&&) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the image size.
+         * \return Image size (in pixels).
+         */
+        [[nodiscard]] math::uint2 getImageSize() const noexcept;
+
+        /**
+         * \brief Get the summed area of all inserted rectangles, excluding padding.
+         * \return Area (in pixels).
+         */
+        [[nodiscard]] uint64_t getUsedArea() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Packing.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Remove all rectangles.
+         */
+        void clear();
+
+        /**
+         * \brief Insert a rectangle. Rectangles of size 0 are placed at (0, 0) and take up no space.
+         * \param rectSize Rectangle size (in pixels).
+         * \return Position of the top-left corner, or empty if the rectangle does not fit.
+         */
+        [[nodiscard]] std::optional<math::uint2> insert(math::uint2 rectSize);
+
+        /**
+         * \brief Pack a list of rectangles into the smallest image that fits all of them. Rectangles are inserted
+         * from tallest to shortest. The image starts at a power-of-two size that can fit the total area and grows one
+         * dimension at a time, so it need not be square.
+         * \param sizes Rectangle sizes (in pixels).
+         * \param rectPadding Number of empty pixels to keep to the right of and below each rectangle.
+         * \param maxImageSize Largest allowed image size. Packing fails if rectangles do not fit in this size.
+         * \return Packing result.
+         */
+        [[nodiscard]] static Result
+          pack(const std::vector<math::uint2>& sizes, uint32_t rectPadding, math::uint2 maxImageSize);
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Horizontal segment of the skyline.
+         */
+        struct Node
+        {
+            uint32_t x;
+            uint32_t y;
+            uint32_t width;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Image size.
+         */
+        math::uint2 size;
+
+        /**
+         * \brief Padding.
+         */
+        uint32_t padding = 0;
+
+        /**
+         * \brief Summed area of all inserted rectangles.
+         */
+        uint64_t usedArea = 0;
+
+        /**
+         * \brief Skyline segments, sorted from left to right.
+         */
+        std::vector<Node> skyline;
+    };
+}  // namespace floah
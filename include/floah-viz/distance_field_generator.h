@@ -0,0 +1,86 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "math/include_all.h"
+
+namespace floah
+{
+    /**
+     * \brief Converts coverage bitmaps to signed distance fields. Distances are exact Euclidean distances between pixel
+     * centers, truncated at the spread. All passes run over contiguous rows with branch-free inner loops so that they
+     * are vectorized by the compiler.
+     */
+    class DistanceFieldGenerator
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        DistanceFieldGenerator();
+
+        DistanceFieldGenerator(const DistanceFieldGenerator&);
+
+        DistanceFieldGenerator(DistanceFieldGenerator&&) noexcept;
+
+        ~DistanceFieldGenerator() noexcept;
+
+        DistanceFieldGenerator& operator=(const DistanceFieldGenerator&);
+
+        DistanceFieldGenerator& operator=(DistanceFieldGenerator&&) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Generate.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Generate a distance field. The output is larger than the input by spread pixels on each side. A value
+         * of 128 lies on the edge, larger values are inside and smaller values are outside. Values saturate at a
+         * distance of spread pixels.
+         * \param bitmap Coverage bitmap. Pixels with a value of 128 or more are inside.
+         * \param bitmapSize Bitmap size (in pixels).
+         * \param pitch Number of bytes between bitmap rows.
+         * \param spread Distance range (in pixels).
+         * \param out Output, (bitmapSize.x + 2 * spread) * (bitmapSize.y + 2 * spread) bytes.
+         */
+        void generate(
+          const uint8_t* bitmap, math::uint2 bitmapSize, size_t pitch, uint32_t spread, std::span<uint8_t> out);
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Generate.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Calculate the squared distance from each pixel to the nearest feature pixel, truncated at the spread.
+         * \param features Per-pixel 0 for feature pixels and a large value otherwise.
+         * \param distances Output squared distances.
+         * \param size Field size (in pixels).
+         * \param spread Distance range (in pixels).
+         */
+        void transform(const std::vector<float>& features,
+                       std::vector<float>&       distances,
+                       math::uint2               size,
+                       uint32_t                  spread);
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Scratch buffers, kept to avoid reallocating for each glyph.
+         */
+        std::vector<float> inside, outside, distInside, distOutside, column;
+    };
+}  // namespace floah
@@ -0,0 +1,245 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace floah
+{
+    /**
+     * \brief Open-addressing hash table with linear probing, keyed by hashes. Keys are used as is to find the first
+     * slot to probe, so they must already be well distributed. All slots are stored in one contiguous list. Elements
+     * cannot be erased.
+     * \tparam T Value type.
+     * \tparam K Key type. 64-bit keys are folded to find the first slot.
+     */
+    template<typename T, std::unsigned_integral K = uint32_t>
+    class FlatMap
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        using Key = K;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        FlatMap() = default;
+
+        FlatMap(const FlatMap&) = default;
+
+        FlatMap(FlatMap&& other) noexcept :
+            slots(std::move(other.slots)), count(std::exchange(other.count, 0))
+        {
+        }
+
+        ~FlatMap() noexcept = default;
+
+        FlatMap& operator=(const FlatMap&) = default;
+
+        FlatMap& operator=(FlatMap&& other) noexcept
+        {
+            slots = std::move(other.slots);
+            count = std::exchange(other.count, 0);
+            return *this;
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the number of elements.
+         * \return Element count.
+         */
+        [[nodiscard]] size_t size() const noexcept { return count; }
+
+        /**
+         * \brief Returns whether there are no elements.
+         * \return True if empty.
+         */
+        [[nodiscard]] bool empty() const noexcept { return count == 0; }
+
+        /**
+         * \brief Find an element.
+         * \param key Key.
+         * \return Value or nullptr if there is no element with the given key.
+         */
+        [[nodiscard]] T* find(const Key key) noexcept
+        {
+            return const_cast<T*>(std::as_const(*this).find(key));
+        }
+
+        /**
+         * \brief Find an element.
+         * \param key Key.
+         * \return Value or nullptr if there is no element with the given key.
+         */
+        [[nodiscard]] const T* find(const Key key) const noexcept
+        {
+            if (slots.empty()) return nullptr;
+            const auto& slot = slots[findSlot(key)];
+            return slot.value ? &*slot.value : nullptr;
+        }
+
+        /**
+         * \brief Call a function for each element, in unspecified order.
+         * \tparam F Function type.
+         * \param f Function taking the key and a reference to the value.
+         */
+        template<typename F>
+        void forEach(F&& f) const
+        {
+            for (const auto& slot : slots)
+                if (slot.value) f(slot.key, *slot.value);
+        }
+
+        /**
+         * \brief Call a function for each element, in unspecified order.
+         * \tparam F Function type.
+         * \param f Function taking the key and a reference to the value.
+         */
+        template<typename F>
+        void forEach(F&& f)
+        {
+            for (auto& slot : slots)
+                if (slot.value) f(slot.key, *slot.value);
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Setters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Insert an element or assign to an existing one.
+         * \tparam U Value type.
+         * \param key Key.
+         * \param value Value.
+         * \return Stored value.
+         */
+        template<typename U>
+        T& insertOrAssign(const Key key, U&& value)
+        {
+            auto& slot = getOrAddSlot(key);
+            if (slot.value)
+                *slot.value = std::forward<U>(value);
+            else
+            {
+                slot.value.emplace(std::forward<U>(value));
+                count++;
+            }
+            return *slot.value;
+        }
+
+        /**
+         * \brief Find an element, or construct a new one if there is none.
+         * \tparam Args Constructor argument types.
+         * \param key Key.
+         * \param args Arguments passed to the constructor of a new value.
+         * \return Stored value.
+         */
+        template<typename... Args>
+        T& tryEmplace(const Key key, Args&&... args)
+        {
+            auto& slot = getOrAddSlot(key);
+            if (!slot.value)
+            {
+                slot.value.emplace(std::forward<Args>(args)...);
+                count++;
+            }
+            return *slot.value;
+        }
+
+        /**
+         * \brief Remove all elements. Keeps the allocated slots.
+         */
+        void clear() noexcept
+        {
+            for (auto& slot : slots) slot.value.reset();
+            count = 0;
+        }
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        struct Slot
+        {
+            Key              key = 0;
+            std::optional<T> value;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Slots.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Find the slot holding a key, or the empty slot at which probing for it stopped. Requires at least one
+         * empty slot.
+         * \param key Key.
+         * \return Slot index.
+         */
+        [[nodiscard]] size_t findSlot(const Key key) const noexcept
+        {
+            auto i = static_cast<size_t>(key);
+            if constexpr (sizeof(Key) > sizeof(uint32_t)) i = static_cast<size_t>(key ^ key >> 32);
+
+            const auto mask = slots.size() - 1;
+            i &= mask;
+            while (slots[i].value && slots[i].key != key) i = (i + 1) & mask;
+            return i;
+        }
+
+        /**
+         * \brief Find the slot holding a key, or claim an empty slot for it. Grows the table to keep the load factor at
+         * or below 3/4.
+         * \param key Key.
+         * \return Slot. Holds no value if it was just claimed, in which case the caller must construct one and
+         * increment the element count.
+         */
+        Slot& getOrAddSlot(const Key key)
+        {
+            if ((count + 1) * 4 > slots.size() * 3) rehash(std::max<size_t>(slots.size() * 2, 8));
+
+            auto& slot = slots[findSlot(key)];
+            slot.key   = key;
+            return slot;
+        }
+
+        /**
+         * \brief Move all elements into a new list of slots.
+         * \param size New slot count. Must be a power of 2.
+         */
+        void rehash(const size_t size)
+        {
+            auto old = std::exchange(slots, std::vector<Slot>(size));
+            for (auto& slot : old)
+            {
+                if (!slot.value) continue;
+                auto& newSlot = slots[findSlot(slot.key)];
+                newSlot.key   = slot.key;
+                newSlot.value = std::move(slot.value);
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        std::vector<Slot> slots;
+
+        size_t count = 0;
+    };
+}  // namespace floah
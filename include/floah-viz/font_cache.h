@@ -0,0 +1,150 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "math/include_all.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/font_map.h"
+#include "floah-viz/mapped_file.h"
+
+namespace floah
+{
+    /**
+     * \brief On-disk cache of generated FontMap images and metrics. Each entry is stored in its own file, named after
+     * a key that is derived from the contents of the font file, the font size and the character list.
+     */
+    class FontCache
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Cached FontMap data.
+         */
+        struct Data
+        {
+            /**
+             * \brief Image size (in pixels).
+             */
+            math::uint2 imageSize;
+
+            int32_t ascender = 0;
+
+            int32_t descender = 0;
+
+            uint32_t emSize = 0;
+
+            float packingEfficiency = 0;
+
+            /**
+             * \brief List of (character code, metrics) pairs.
+             */
+            std::vector<std::pair<uint32_t, FontMap::Character>> characters;
+
+            /**
+             * \brief R8 image data, imageSize.x * imageSize.y bytes.
+             */
+            std::span<const uint8_t> pixels;
+
+            /**
+             * \brief When loaded from the cache, pixels point into this mapping.
+             */
+            MappedFile file;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        FontCache();
+
+        /**
+         * \brief Construct a new FontCache.
+         * \param cacheDirectory Directory in which cache files are stored. Created when the first entry is stored.
+         */
+        explicit FontCache(std::filesystem::path cacheDirectory);
+
+        FontCache(const FontCache&);
+
+        FontCache(FontCache&&) noexcept;
+
+        ~FontCache() noexcept;
+
+        FontCache& operator=(const FontCache&);
+
+        FontCache& operator=(FontCache&&) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the cache directory.
+         * \return Directory.
+         */
+        [[nodiscard]] const std::filesystem::path& getDirectory() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Cache.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Calculate the key of a cache entry. Reads the whole font file.
+         * \param fontPath Path to the font file.
+         * \param fontSize Font size.
+         * \param characters List of characters.
+         * \param distanceFieldSpread Distance field range, or 0.
+         * \return Key.
+         */
+        [[nodiscard]] static uint64_t calculateKey(const std::filesystem::path& fontPath,
+                                                   math::uint2                  fontSize,
+                                                   const std::string&           characters,
+                                                   uint32_t                     distanceFieldSpread);
+
+        /**
+         * \brief Load an entry. Entries that are missing, truncated, corrupt, of a different format version or
+         * stored under a different key are rejected.
+         * \param key Key.
+         * \return Data, or empty if there is no valid entry.
+         */
+        [[nodiscard]] std::optional<Data> load(uint64_t key) const;
+
+        /**
+         * \brief Store an entry, replacing any existing entry with the same key. Failure to write is not an error,
+         * as the entry can always be regenerated.
+         * \param key Key.
+         * \param data Data.
+         * \return True if entry was written.
+         */
+        bool store(uint64_t key, const Data& data) const;
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Cache directory.
+         */
+        std::filesystem::path directory;
+    };
+}  // namespace floah
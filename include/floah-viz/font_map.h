@@ -5,8 +5,10 @@
 ////////////////////////////////////////////////////////////////
 
 #include <filesystem>
+#include <memory>
 #include <string>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////
 // Module includes.
@@ -36,6 +38,15 @@ namespace floah
             int32_t      advance;
         };
 
+        /**
+         * \brief Rectangle in the image that was modified after the texture was generated.
+         */
+        struct Region
+        {
+            math::uint2 offset;
+            math::uint2 size;
+        };
+
         ////////////////////////////////////////////////////////////////
         // Constructors.
         ////////////////////////////////////////////////////////////////
@@ -45,10 +56,10 @@ namespace floah
         /**
          * \brief Construct a new FontMap from a list of characters. Does not yet generate the actual texture.
          * \param fontPath Path to the font file.
-         * \param characters List of characters that must be loaded into the map.
+         * \param characterList List of characters that must be loaded into the map.
          * \param fontSize Size of the loaded font face. If one component is 0, it is derived from the other.
          */
-        FontMap(std::filesystem::path fontPath, const char* characters, math::uint2 fontSize);
+        FontMap(std::filesystem::path fontPath, const char* characterList, math::uint2 fontSize);
 
         /**
          * \brief Construct a new FontMap from a range of character codes. Does not yet generate the actual texture.
@@ -102,6 +113,12 @@ namespace floah
          */
         [[nodiscard]] int32_t getFontDescender() const noexcept;
 
+        /**
+         * \brief Get the fraction of the image area that is covered by glyphs.
+         * \return Packing efficiency in the range [0, 1], or 0 if image was not generated yet.
+         */
+        [[nodiscard]] float getPackingEfficiency() const noexcept;
+
         /**
          * \brief Get image object.
          * \return Image (or nullptr if image was not generated yet).
@@ -121,20 +138,190 @@ namespace floah
          */
         [[nodiscard]] const Character& getCharacter(uint32_t c) const;
 
+        /**
+         * \brief Returns whether missing characters are loaded on demand.
+         * \return True if dynamic.
+         */
+        [[nodiscard]] bool isDynamic() const noexcept;
+
+        /**
+         * \brief Get the generation counter. It is incremented each time a dynamic FontMap evicts a character to make
+         * room for another. Geometry generated at an older generation may reference image regions that now hold
+         * different characters.
+         * \return Generation.
+         */
+        [[nodiscard]] uint64_t getGeneration() const noexcept;
+
+        /**
+         * \brief Get all image regions that were modified since the last call to clearDirtyRegions. The staging data of
+         * these regions has been updated and must be uploaded to the texture.
+         * \return List of regions.
+         */
+        [[nodiscard]] const std::vector<Region>& getDirtyRegions() const noexcept;
+
+        /**
+         * \brief Get the maximum number of threads used to rasterize glyphs.
+         * \return Thread count, or 0 to use all hardware threads.
+         */
+        [[nodiscard]] uint32_t getThreadCount() const noexcept;
+
+        /**
+         * \brief Get the directory in which generated images are cached.
+         * \return Directory, or empty if caching is disabled.
+         */
+        [[nodiscard]] const std::filesystem::path& getCacheDirectory() const noexcept;
+
+        /**
+         * \brief Get the size of the em square the glyphs were rasterized at. Divide a desired font size by this value
+         * to get the factor by which all character metrics must be scaled.
+         * \return Em size (in pixels), or 0 if image was not generated yet.
+         */
+        [[nodiscard]] uint32_t getEmSize() const noexcept;
+
+        /**
+         * \brief Get the range of the distance field.
+         * \return Spread (in pixels), or 0 if this FontMap holds regular coverage bitmaps.
+         */
+        [[nodiscard]] uint32_t getDistanceFieldSpread() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Setters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Set the maximum number of threads used to rasterize glyphs. Each thread loads its own copy of the
+         * font face. Small character lists are always rasterized on the calling thread. Must be called before
+         * generateTexture to have any effect.
+         * \param count Thread count, or 0 to use all hardware threads.
+         */
+        void setThreadCount(uint32_t count) noexcept;
+
+        /**
+         * \brief Set the directory in which generated images and metrics are cached. When a valid cache entry for the
+         * same font file contents, font size and character list exists, generateTexture loads it instead of running
+         * FreeType. Otherwise, a new entry is written after generating. Must be called before generateTexture to have
+         * any effect.
+         * \param directory Directory, or empty to disable caching.
+         */
+        void setCacheDirectory(std::filesystem::path directory);
+
+        /**
+         * \brief Load missing characters on demand instead of only the character list passed on construction. The image
+         * is divided into cells that each fit the largest glyph of the face. When all cells are in use, the least
+         * recently used character is evicted. Disables caching. Must be called before generateTexture to have any
+         * effect.
+         * \param imageSize Fixed image size (in pixels).
+         */
+        void setDynamic(math::uint2 imageSize);
+
+        /**
+         * \brief Store signed distance fields instead of coverage bitmaps, so that a single image can render text at
+         * any size. A value of 128 lies on the glyph outline. Glyph sizes and bearings include the spread on each side.
+         * The image then uses VK_FORMAT_R8_UNORM instead of VK_FORMAT_R8_UINT, so that it can be sampled with linear
+         * filtering. Must be called before generateTexture to have any effect.
+         * \param spread Distance range (in pixels at the em size), or 0 to store coverage bitmaps.
+         */
+        void setDistanceField(uint32_t spread) noexcept;
+
+        /**
+         * \brief Clear the list of dirty regions. Call after uploading them.
+         */
+        void clearDirtyRegions() noexcept;
+
         ////////////////////////////////////////////////////////////////
         // Generate.
         ////////////////////////////////////////////////////////////////
 
+        /**
+         * \brief Rasterize and pack all characters, or load them from the cache, without creating any image or texture
+         * objects. Afterwards, all metrics and characters can be retrieved. Allows doing the CPU work on a different
+         * thread than the one that creates the texture. Called by generateTexture if it was not called before. Does
+         * nothing if this FontMap is dynamic.
+         */
+        void generateImageData();
+
         /**
          * \brief Generate the image and texture objects.
          * \param textureManager TextureManager used to create the image and texture objects.
          */
         void generateTexture(sol::TextureManager& textureManager);
 
-        // TODO: Add support for updating FontMap? New characters, different font, font size, etc.
+        /**
+         * \brief Retrieve the metrics for a character and mark it as recently used. If this FontMap is dynamic and the
+         * character is missing, it is rasterized into the image, possibly evicting another character. The returned
+         * reference remains valid, but its contents change if the character is evicted later on. Requires the texture
+         * to have been generated.
+         * \param c Character code.
+         * \return Character metrics.
+         */
+        [[nodiscard]] const Character& acquireCharacter(uint32_t c);
+
+        // TODO: Add support for updating FontMap? Different font, font size, etc.
 
 
     private:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief State of a dynamic FontMap.
+         */
+        struct DynamicState;
+
+        /**
+         * \brief Image data that was generated but not yet uploaded.
+         */
+        struct ImageData;
+
+        ////////////////////////////////////////////////////////////////
+        // Character lookup.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Find the metrics for a character.
+         * \param c Character code.
+         * \return Character metrics or nullptr if character is not in this map.
+         */
+        [[nodiscard]] const Character* findCharacter(uint32_t c) const noexcept;
+
+        /**
+         * \brief Replace all character metrics and rebuild the lookup tables. If a character code occurs more than
+         * once, the first occurrence is kept.
+         * \param list List of (character code, metrics) pairs.
+         */
+        void setCharacters(std::vector<std::pair<uint32_t, Character>> list);
+
+        /**
+         * \brief Point a character code to an element of the characters list.
+         * \param c Character code.
+         * \param index Index into characters list.
+         */
+        void insertCharacter(uint32_t c, uint32_t index);
+
+        /**
+         * \brief Remove a character code from the lookup tables. Does not modify the characters list.
+         * \param c Character code.
+         */
+        void eraseCharacter(uint32_t c) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Dynamic.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Create the dynamic state and an empty image, and load the character list.
+         * \param textureManager TextureManager used to create the image and texture objects.
+         */
+        void generateDynamicTexture(sol::TextureManager& textureManager);
+
+        /**
+         * \brief Rasterize a character into a free or evicted cell.
+         * \param c Character code.
+         * \return Character metrics, or nullptr if the character could not be loaded.
+         */
+        const Character* loadCharacter(uint32_t c);
+
         ////////////////////////////////////////////////////////////////
         // Member variables.
         ////////////////////////////////////////////////////////////////
@@ -158,6 +345,56 @@ namespace floah
 
         int32_t descender = 0;
 
+        /**
+         * \brief Pixel size of the em square.
+         */
+        uint32_t emSize = 0;
+
+        /**
+         * \brief Used glyph area divided by image area.
+         */
+        float packingEfficiency = 0;
+
+        /**
+         * \brief Maximum number of threads used to rasterize glyphs.
+         */
+        uint32_t threadCount = 0;
+
+        /**
+         * \brief Cache directory.
+         */
+        std::filesystem::path cacheDirectory;
+
+        /**
+         * \brief Distance field range, or 0 if not a distance field.
+         */
+        uint32_t distanceFieldSpread = 0;
+
+        /**
+         * \brief Image size of a dynamic FontMap, or 0 if not dynamic.
+         */
+        math::uint2 dynamicImageSize{0, 0};
+
+        /**
+         * \brief Incremented on each eviction.
+         */
+        uint64_t generation = 0;
+
+        /**
+         * \brief Image regions modified after generating.
+         */
+        std::vector<Region> dirtyRegions;
+
+        /**
+         * \brief Dynamic state. Only created after generating a dynamic FontMap.
+         */
+        std::unique_ptr<DynamicState> dynamic;
+
+        /**
+         * \brief Result of generateImageData. Released once the texture is generated.
+         */
+        std::unique_ptr<ImageData> imageData;
+
         /**
          * \brief Image.
          */
@@ -168,11 +405,22 @@ namespace floah
          */
         sol::Texture2D* texture = nullptr;
 
-        // TODO: If we only allowed (a) contiguous range(s) of characters, we wouldn't need this silly map, just a vector.
-        // Would sure make constructing text geometry a lot faster.
         /**
-         * \brief Map with per-character metrics.
+         * \brief Per-character metrics, stored contiguously.
+         */
+        std::vector<Character> characters;
+
+        /**
+         * \brief Lookup table indexed directly by character code, for all codes in the Basic Multilingual Plane up to
+         * the highest code in this map. Holds an index into the characters list, or
+         * uint32_t max if the code is not in this map.
+         */
+        std::vector<uint32_t> denseIndex;
+
+        /**
+         * \brief List of (character code, index into characters list) pairs for all codes outside of the Basic
+         * Multilingual Plane. Sorted by character code.
          */
-        std::unordered_map<uint32_t, Character> characterMap;
+        std::vector<std::pair<uint32_t, uint32_t>> sparseIndex;
     };
 }  // namespace floah
@@ -0,0 +1,120 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace floah
+{
+    /**
+     * \brief Monotonic memory resource for scratch memory that only lives for a single frame. Allocating bumps a
+     * pointer and deallocating does nothing. All memory is reclaimed at once by calling reset, which should be done
+     * once per frame after all generators have run. When a frame needs more memory than the arena holds, additional
+     * blocks are allocated and merged into a single larger block on the next reset, so that steady-state frames do not
+     * allocate.
+     */
+    class FrameArena final : public std::pmr::memory_resource
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        FrameArena();
+
+        /**
+         * \brief Construct a new arena.
+         * \param initialCapacity Size of the first block (in bytes).
+         */
+        explicit FrameArena(size_t initialCapacity);
+
+        FrameArena(const FrameArena&) = delete;
+
+        FrameArena(FrameArena&&) noexcept = delete;
+
+        ~FrameArena() noexcept override;
+
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        FrameArena& operator=(FrameArena&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the number of bytes allocated since the last reset, including alignment padding.
+         * \return Byte count.
+         */
+        [[nodiscard]] size_t getUsed() const noexcept;
+
+        /**
+         * \brief Get the total size of all blocks.
+         * \return Byte count.
+         */
+        [[nodiscard]] size_t getCapacity() const noexcept;
+
+        /**
+         * \brief Get the largest number of bytes that was in use at once since construction. Can be used to choose the
+         * initial capacity.
+         * \return Byte count.
+         */
+        [[nodiscard]] size_t getHighWaterMark() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Reset.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Reclaim all memory. Invalidates everything that was allocated from this arena.
+         */
+        void reset();
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> data;
+            size_t                       size = 0;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Memory resource.
+        ////////////////////////////////////////////////////////////////
+
+        void* do_allocate(size_t bytes, size_t alignment) override;
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief List of blocks. Allocations are made from the last block.
+         */
+        std::vector<Block> blocks;
+
+        /**
+         * \brief Offset of the first free byte in the last block.
+         */
+        size_t offset = 0;
+
+        /**
+         * \brief Bytes used by all blocks before the last one.
+         */
+        size_t previousUsed = 0;
+
+        size_t highWaterMark = 0;
+    };
+}  // namespace floah
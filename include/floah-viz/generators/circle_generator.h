@@ -1,5 +1,12 @@
 #pragma once
 
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <span>
+#include <vector>
+
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
@@ -11,6 +18,7 @@
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "floah-viz/shape_instance.h"
 #include "floah-viz/generators/generator.h"
 
 namespace floah
@@ -41,12 +49,83 @@ namespace floah
 
         CircleGenerator& operator=(CircleGenerator&&) noexcept = delete;
 
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the number of segments the circle is tessellated with.
+         * \return vertexCount, or a count derived from radius and maxChordError if maxChordError is greater than 0.
+         * Derived counts are rounded up to a multiple of 8.
+         */
+        [[nodiscard]] uint32_t getSegmentCount() const;
+
         ////////////////////////////////////////////////////////////////
         // Generate.
         ////////////////////////////////////////////////////////////////
 
+        /**
+         * \brief Generate geometry. If params.mesh is set, it must be an IndexedMesh. Its vertex data is replaced in
+         * place, and the drawn index range is only changed when fillMode changed.
+         * \param params Parameters.
+         * \return Mesh.
+         */
         [[nodiscard]] sol::IMesh& generate(Params& params) override;
 
+        using Generator::emit;
+
+        /**
+         * \brief Get the number of vertices and indices that emit writes. Only indices that are drawn based on fillMode
+         * are counted.
+         * \return Counts.
+         */
+        [[nodiscard]] Counts measure() override;
+
+        /**
+         * \brief Write geometry into caller-provided buffers. Only the indices that are drawn based on fillMode are
+         * written.
+         * \param fontMap FontMap.
+         * \param vertices Output vertices.
+         * \param indices Output indices.
+         * \param firstVertex Offset added to each index.
+         */
+        void emit(FontMap&            fontMap,
+                  std::span<Vertex>   vertices,
+                  std::span<uint32_t> indices,
+                  uint32_t            firstVertex) override;
+
+        /**
+         * \brief Write geometry in the compact vertex format.
+         * \param fontMap FontMap.
+         * \param vertices Output vertices.
+         * \param indices Output indices.
+         * \param firstVertex Offset added to each index.
+         */
+        void emit(FontMap&                fontMap,
+                  std::span<CompactVertex> vertices,
+                  std::span<uint32_t>      indices,
+                  uint32_t                 firstVertex) override;
+
+        ////////////////////////////////////////////////////////////////
+        // Instancing.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Create the mesh that is shared by all instanced circles with the same vertex count. See ShapeInstance
+         * for how its vertices must be placed. The radius of an instance is half the width of its bounds.
+         * \param meshManager MeshManager.
+         * \param vertexCount Number of vertices on the circle.
+         * \return Mesh.
+         */
+        [[nodiscard]] static sol::IndexedMesh& createUnitMesh(sol::MeshManager& meshManager, uint32_t vertexCount);
+
+        /**
+         * \brief Append an instance record instead of generating geometry. vertexCount is ignored, it is a property of
+         * the unit mesh.
+         * \param instances Instance list.
+         */
+        void appendInstance(std::vector<ShapeInstance>& instances) const;
+
         ////////////////////////////////////////////////////////////////
         // Member variables.
         ////////////////////////////////////////////////////////////////
@@ -62,10 +141,17 @@ namespace floah
         float radius;
 
         /**
-         * \brief Number of vertices.
+         * \brief Number of vertices. Ignored if maxChordError is greater than 0.
          */
         uint32_t vertexCount = 8;
 
+        /**
+         * \brief Maximum distance (in pixels) between a segment and the arc it approximates. If greater than 0, the
+         * number of vertices is derived from radius, so that small circles use few vertices and large circles remain
+         * smooth.
+         */
+        float maxChordError = 0;
+
         /**
          * \brief FillMode.
          */
@@ -75,5 +161,94 @@ namespace floah
          * \brief Width of the outline.
          */
         Length margin;
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Generate.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Write geometry in any vertex format that has a VertexTraits specialization.
+         * \tparam V Vertex type.
+         * \param vertices Output vertices.
+         * \param indices Output indices.
+         * \param firstVertex Offset added to each index.
+         */
+        template<typename V>
+        void emitGeometry(std::span<V> vertices, std::span<uint32_t> indices, uint32_t firstVertex);
+
+        /**
+         * \brief Write all count * 3 + 1 vertices.
+         * \tparam V Vertex type.
+         * \param vertices Output vertices.
+         * \param count Segment count.
+         */
+        template<typename V>
+        void writeVertices(V* vertices, uint32_t count);
+
+        /**
+         * \brief Get the points on the unit circle for a segment count. The table is looked up again only when the
+         * count differs from the previous call.
+         * \param count Segment count.
+         * \return List of count points.
+         */
+        [[nodiscard]] const std::vector<math::float2>& getUnitCircle(uint32_t count);
+
+        /**
+         * \brief Write the vertexCount * 6 indices of the outline rim.
+         * \param indices Output indices.
+         * \param vertexCount Number of vertices on the circle.
+         * \param base Offset added to each index.
+         */
+        static void writeRimIndices(uint32_t* indices, uint32_t vertexCount, uint32_t base);
+
+        /**
+         * \brief Write the vertexCount * 3 indices of the triangle fan.
+         * \param indices Output indices.
+         * \param vertexCount Number of vertices on the circle.
+         * \param base Offset added to each index.
+         */
+        static void writeFanIndices(uint32_t* indices, uint32_t vertexCount, uint32_t base);
+
+        /**
+         * \brief Set the drawn index range of a mesh based on fillMode.
+         * \param indexedMesh Mesh.
+         * \param count Segment count.
+         */
+        void setIndexRange(sol::IndexedMesh& indexedMesh, uint32_t count);
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Mesh returned by the last call to generate.
+         */
+        sol::IndexedMesh* mesh = nullptr;
+
+        /**
+         * \brief fillMode at the time the drawn index range of mesh was set.
+         */
+        FillMode meshFillMode = FillMode::Both;
+
+        /**
+         * \brief Segment count at the time the drawn index range of mesh was set.
+         */
+        uint32_t meshVertexCount = 0;
+
+        /**
+         * \brief Unit circle table returned by the last call to getUnitCircle.
+         */
+        const std::vector<math::float2>* unitCircle = nullptr;
+
+        /**
+         * \brief Segment count of unitCircle.
+         */
+        uint32_t unitCircleCount = 0;
+
+        /**
+         * \brief Storage for unitCircle if the segment count is too large for the shared tables.
+         */
+        std::vector<math::float2> ownedUnitCircle;
     };
 }  // namespace floah
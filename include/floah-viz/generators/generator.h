@@ -1,5 +1,14 @@
 #pragma once
 
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
@@ -11,6 +20,8 @@
 ////////////////////////////////////////////////////////////////
 
 #include "floah-viz/font_map.h"
+#include "floah-viz/frame_arena.h"
+#include "floah-viz/vertex.h"
 
 namespace floah
 {
@@ -30,6 +41,20 @@ namespace floah
              * \brief If not null, update mesh instead of creating new one.
              */
             sol::IMesh* mesh = nullptr;
+
+            /**
+             * \brief If not null, arena used for scratch memory that is only needed during the call to generate.
+             */
+            FrameArena* arena = nullptr;
+        };
+
+        /**
+         * \brief Number of vertices and indices.
+         */
+        struct Counts
+        {
+            uint32_t vertexCount = 0;
+            uint32_t indexCount  = 0;
         };
 
         ////////////////////////////////////////////////////////////////
@@ -53,5 +78,81 @@ namespace floah
         ////////////////////////////////////////////////////////////////
 
         [[nodiscard]] virtual sol::IMesh& generate(Params& params) = 0;
+
+        /**
+         * \brief Get the number of vertices and indices that emit writes with the current parameters.
+         * \return Counts.
+         */
+        [[nodiscard]] virtual Counts measure() = 0;
+
+        /**
+         * \brief Write geometry directly into caller-provided buffers, such as a mapped staging region or an arena,
+         * instead of generating a separate mesh. The buffers must hold exactly the counts returned by measure.
+         * \param fontMap FontMap.
+         * \param vertices Output vertices.
+         * \param indices Output indices.
+         * \param firstVertex Offset added to each index, i.e. the position of vertices[0] in the vertex buffer.
+         */
+        virtual void
+          emit(FontMap& fontMap, std::span<Vertex> vertices, std::span<uint32_t> indices, uint32_t firstVertex) = 0;
+
+        /**
+         * \brief Write geometry in the compact vertex format.
+         * \param fontMap FontMap.
+         * \param vertices Output vertices.
+         * \param indices Output indices.
+         * \param firstVertex Offset added to each index.
+         */
+        virtual void emit(FontMap&                fontMap,
+                          std::span<CompactVertex> vertices,
+                          std::span<uint32_t>      indices,
+                          uint32_t                 firstVertex) = 0;
+
+        /**
+         * \brief Write geometry as distance function shaded quads. Only supported by generators of shapes that have a
+         * distance function. The default implementation throws a FloahError.
+         * \param fontMap FontMap.
+         * \param vertices Output vertices.
+         * \param indices Output indices.
+         * \param firstVertex Offset added to each index.
+         */
+        virtual void
+          emit(FontMap& fontMap, std::span<ShapeVertex> vertices, std::span<uint32_t> indices, uint32_t firstVertex);
+
+        /**
+         * \brief Append geometry to a shared vertex and index list. Indices are offset by the number of vertices
+         * already in the list. The lists may use any allocator, e.g. a std::pmr allocator backed by a FrameArena.
+         * \tparam V Vertex type.
+         * \tparam VA Vertex allocator type.
+         * \tparam IA Index allocator type.
+         * \param fontMap FontMap.
+         * \param vertices Vertex list.
+         * \param indices Index list.
+         */
+        template<typename V, typename VA, typename IA>
+        void append(FontMap& fontMap, std::vector<V, VA>& vertices, std::vector<uint32_t, IA>& indices)
+        {
+            const auto counts      = measure();
+            const auto firstVertex = vertices.size();
+            const auto firstIndex  = indices.size();
+            vertices.resize(firstVertex + counts.vertexCount);
+            indices.resize(firstIndex + counts.indexCount);
+            emit(fontMap,
+                 std::span(vertices).subspan(firstVertex),
+                 std::span(indices).subspan(firstIndex),
+                 static_cast<uint32_t>(firstVertex));
+        }
+
+    protected:
+        ////////////////////////////////////////////////////////////////
+        // Scratch memory.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the memory resource to allocate scratch memory from.
+         * \param params Parameters.
+         * \return Arena of params, or the default memory resource if there is none.
+         */
+        [[nodiscard]] static std::pmr::memory_resource* getScratchResource(const Params& params) noexcept;
     };
 }  // namespace floah
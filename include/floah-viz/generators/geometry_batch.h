@@ -0,0 +1,240 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "sol/mesh/fwd.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/vertex.h"
+#include "floah-viz/generators/generator.h"
+
+namespace floah
+{
+    /**
+     * \brief Collects the geometry of many generators into a single vertex and index list, so that they can be drawn
+     * with one mesh. Each item keeps a stable handle and sub-range, and can be updated or removed in place.
+     * \tparam V Vertex type. Either Vertex, CompactVertex or ShapeVertex.
+     */
+    template<typename V>
+    class BasicGeometryBatch
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        using Handle = uint32_t;
+
+        /**
+         * \brief Sub-range of the vertex and index lists occupied by an item.
+         */
+        struct Range
+        {
+            uint32_t firstVertex = 0;
+            uint32_t vertexCount = 0;
+            uint32_t firstIndex  = 0;
+            uint32_t indexCount  = 0;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        BasicGeometryBatch();
+
+        BasicGeometryBatch(const BasicGeometryBatch&) = delete;
+
+        BasicGeometryBatch(BasicGeometryBatch&&) noexcept;
+
+        ~BasicGeometryBatch() noexcept;
+
+        BasicGeometryBatch& operator=(const BasicGeometryBatch&) = delete;
+
+        BasicGeometryBatch& operator=(BasicGeometryBatch&&) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the number of items that were added and not removed.
+         * \return Item count.
+         */
+        [[nodiscard]] uint32_t getItemCount() const noexcept;
+
+        /**
+         * \brief Get the vertex list, including slack and vertices of removed items.
+         * \return Vertices.
+         */
+        [[nodiscard]] const std::vector<V>& getVertices() const noexcept;
+
+        /**
+         * \brief Get the index list, including slack and indices of removed items.
+         * \return Indices.
+         */
+        [[nodiscard]] const std::vector<uint32_t>& getIndices() const noexcept;
+
+        /**
+         * \brief Get the number of vertices that are not used by any item. Call compact to reclaim them.
+         * \return Vertex count.
+         */
+        [[nodiscard]] uint32_t getUnusedVertexCount() const noexcept;
+
+        /**
+         * \brief Get the sub-range occupied by an item.
+         * \param handle Item handle.
+         * \return Range.
+         */
+        [[nodiscard]] Range getRange(Handle handle) const;
+
+        ////////////////////////////////////////////////////////////////
+        // Items.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Append the geometry of a generator.
+         * \param generator Generator.
+         * \param fontMap FontMap.
+         * \return Item handle.
+         */
+        Handle add(Generator& generator, FontMap& fontMap);
+
+        /**
+         * \brief Regenerate the geometry of an item. If the new geometry fits in the sub-range of the item, it is
+         * written in place. Otherwise, the old sub-range is collapsed and the item is moved to the end of the lists
+         * with some slack, so that it can grow a little without moving again. If the generator throws while the item
+         * is moved, the item keeps its old geometry. If it throws while the item is written in place, the item is left
+         * empty, as its old geometry may already be partially overwritten.
+         * \param handle Item handle.
+         * \param generator Generator.
+         * \param fontMap FontMap.
+         */
+        void update(Handle handle, Generator& generator, FontMap& fontMap);
+
+        /**
+         * \brief Remove an item. Its sub-range is collapsed into degenerate triangles and its handle can be reused.
+         * \param handle Item handle.
+         */
+        void remove(Handle handle);
+
+        /**
+         * \brief Remove all items.
+         */
+        void clear() noexcept;
+
+        /**
+         * \brief Remove all slack and sub-ranges of removed items. Handles remain valid, but sub-ranges change.
+         */
+        void compact();
+
+        ////////////////////////////////////////////////////////////////
+        // Generate.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Generate a single mesh containing all items.
+         * \param meshManager MeshManager.
+         * \param mesh If not null, update this mesh instead of creating a new one. Must be an IndexedMesh.
+         * \return Mesh.
+         */
+        [[nodiscard]] sol::IMesh& generate(sol::MeshManager& meshManager, sol::IMesh* mesh = nullptr);
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        struct Item
+        {
+            uint32_t firstVertex    = 0;
+            uint32_t vertexCount    = 0;
+            uint32_t vertexCapacity = 0;
+            uint32_t firstIndex     = 0;
+            uint32_t indexCount     = 0;
+            uint32_t indexCapacity  = 0;
+            bool     alive          = false;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Items.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get a live item.
+         * \param handle Item handle.
+         * \return Item.
+         */
+        [[nodiscard]] Item& getItem(Handle handle);
+
+        [[nodiscard]] const Item& getItem(Handle handle) const;
+
+        /**
+         * \brief Write the geometry of a generator into the sub-range of an item, relocating it if it does not fit. If
+         * the generator throws, a newly reserved sub-range is released again. See update.
+         * \param item Item.
+         * \param generator Generator.
+         * \param fontMap FontMap.
+         * \param slack If true, reserve some extra room when relocating.
+         */
+        void write(Item& item, Generator& generator, FontMap& fontMap, bool slack);
+
+        /**
+         * \brief Collapse the whole sub-range of an item into degenerate triangles.
+         * \param item Item.
+         */
+        void collapse(const Item& item);
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Items, indexed by handle.
+         */
+        std::vector<Item> items;
+
+        /**
+         * \brief Handles of removed items that can be reused.
+         */
+        std::vector<Handle> freeHandles;
+
+        /**
+         * \brief Vertex data of all items.
+         */
+        std::vector<V> vertices;
+
+        /**
+         * \brief Index data of all items.
+         */
+        std::vector<uint32_t> indices;
+
+        /**
+         * \brief Number of vertices in use by live items.
+         */
+        uint32_t usedVertexCount = 0;
+    };
+
+    extern template class BasicGeometryBatch<Vertex>;
+
+    extern template class BasicGeometryBatch<CompactVertex>;
+
+    extern template class BasicGeometryBatch<ShapeVertex>;
+
+    using GeometryBatch = BasicGeometryBatch<Vertex>;
+
+    using CompactGeometryBatch = BasicGeometryBatch<CompactVertex>;
+
+    using ShapeGeometryBatch = BasicGeometryBatch<ShapeVertex>;
+}  // namespace floah
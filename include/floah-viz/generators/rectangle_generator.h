@@ -1,5 +1,12 @@
 #pragma once
 
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <span>
+#include <utility>
+
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
@@ -11,6 +18,7 @@
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "floah-viz/shape_instance.h"
 #include "floah-viz/generators/generator.h"
 
 namespace floah
@@ -45,8 +53,66 @@ namespace floah
         // Generate.
         ////////////////////////////////////////////////////////////////
 
+        /**
+         * \brief Generate geometry. If params.mesh is set, it must be an IndexedMesh. Its vertex data is replaced in
+         * place, and the drawn index range is only changed when fillMode changed.
+         * \param params Parameters.
+         * \return Mesh.
+         */
         [[nodiscard]] sol::IMesh& generate(Params& params) override;
 
+        using Generator::emit;
+
+        /**
+         * \brief Get the number of vertices and indices that emit writes. Only indices that are drawn based on fillMode
+         * are counted.
+         * \return Counts.
+         */
+        [[nodiscard]] Counts measure() override;
+
+        /**
+         * \brief Write geometry into caller-provided buffers. Only the indices that are drawn based on fillMode are
+         * written.
+         * \param fontMap FontMap.
+         * \param vertices Output vertices.
+         * \param indices Output indices.
+         * \param firstVertex Offset added to each index.
+         */
+        void emit(FontMap&            fontMap,
+                  std::span<Vertex>   vertices,
+                  std::span<uint32_t> indices,
+                  uint32_t            firstVertex) override;
+
+        /**
+         * \brief Write geometry in the compact vertex format.
+         * \param fontMap FontMap.
+         * \param vertices Output vertices.
+         * \param indices Output indices.
+         * \param firstVertex Offset added to each index.
+         */
+        void emit(FontMap&                fontMap,
+                  std::span<CompactVertex> vertices,
+                  std::span<uint32_t>      indices,
+                  uint32_t                 firstVertex) override;
+
+        ////////////////////////////////////////////////////////////////
+        // Instancing.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Create the mesh that is shared by all instanced rectangles. See ShapeInstance for how its vertices
+         * must be placed. The uv of inner vertices must be moved inwards by margin / (upper - lower).
+         * \param meshManager MeshManager.
+         * \return Mesh.
+         */
+        [[nodiscard]] static sol::IndexedMesh& createUnitMesh(sol::MeshManager& meshManager);
+
+        /**
+         * \brief Append an instance record instead of generating geometry.
+         * \param instances Instance list.
+         */
+        void appendInstance(std::vector<ShapeInstance>& instances) const;
+
         ////////////////////////////////////////////////////////////////
         // Member variables.
         ////////////////////////////////////////////////////////////////
@@ -75,5 +141,54 @@ namespace floah
          * \brief Vertex color.
          */
         math::float4 color = {1, 1, 1, 1};
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Generate.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Write geometry in any vertex format that has a VertexTraits specialization.
+         * \tparam V Vertex type.
+         * \param vertices Output vertices.
+         * \param indices Output indices.
+         * \param firstVertex Offset added to each index.
+         */
+        template<typename V>
+        void emitGeometry(std::span<V> vertices, std::span<uint32_t> indices, uint32_t firstVertex) const;
+
+        /**
+         * \brief Write all 8 vertices.
+         * \tparam V Vertex type.
+         * \param vertices Output vertices.
+         */
+        template<typename V>
+        void writeVertices(V* vertices) const;
+
+        /**
+         * \brief Get the range of indices that is drawn based on fillMode.
+         * \return (first index, index count).
+         */
+        [[nodiscard]] std::pair<uint32_t, uint32_t> getIndexRange() const noexcept;
+
+        /**
+         * \brief Set the drawn index range of a mesh based on fillMode.
+         * \param indexedMesh Mesh.
+         */
+        void setIndexRange(sol::IndexedMesh& indexedMesh);
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Mesh returned by the last call to generate.
+         */
+        sol::IndexedMesh* mesh = nullptr;
+
+        /**
+         * \brief fillMode at the time the drawn index range of mesh was set.
+         */
+        FillMode meshFillMode = FillMode::Both;
     };
 }  // namespace floah
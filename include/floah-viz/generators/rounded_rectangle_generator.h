@@ -0,0 +1,174 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-common/length.h"
+#include "math/include_all.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/vertex.h"
+#include "floah-viz/generators/generator.h"
+
+namespace floah
+{
+    /**
+     * \brief Generates a single quad of ShapeVertex vertices that is shaded with the signed distance function of a
+     * rounded rectangle, instead of tessellating the shape. Circles are rounded rectangles with equal width and height
+     * and a corner radius of half the width. Shading must match getDistance, which can be used to test the output on
+     * the CPU.
+     */
+    class RoundedRectangleGenerator : public Generator
+    {
+    public:
+        enum class FillMode
+        {
+            Outline = 1,
+            Fill    = 2,
+            Both    = 3
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        RoundedRectangleGenerator();
+
+        RoundedRectangleGenerator(const RoundedRectangleGenerator&) = delete;
+
+        RoundedRectangleGenerator(RoundedRectangleGenerator&&) noexcept = delete;
+
+        ~RoundedRectangleGenerator() noexcept override;
+
+        RoundedRectangleGenerator& operator=(const RoundedRectangleGenerator&) = delete;
+
+        RoundedRectangleGenerator& operator=(RoundedRectangleGenerator&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Evaluate the signed distance function of the shape, as it must be evaluated by the fragment shader.
+         * \param point Point (in pixels).
+         * \return Distance to the edge of the shape (in pixels). Negative inside of the shape.
+         */
+        [[nodiscard]] float getDistance(math::float2 point) const;
+
+        ////////////////////////////////////////////////////////////////
+        // Generate.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Generate a mesh with ShapeVertex vertices. If params.mesh is set, its data is replaced in place.
+         * \param params Parameters.
+         * \return Mesh.
+         */
+        [[nodiscard]] sol::IMesh& generate(Params& params) override;
+
+        /**
+         * \brief Get the number of vertices and indices that emit writes: always 4 vertices and 6 indices.
+         * \return Counts.
+         */
+        [[nodiscard]] Counts measure() override;
+
+        /**
+         * \brief Not supported, throws a FloahError. The shape can only be drawn with ShapeVertex vertices.
+         * \param fontMap FontMap.
+         * \param vertices Output vertices.
+         * \param indices Output indices.
+         * \param firstVertex Offset added to each index.
+         */
+        void emit(FontMap&            fontMap,
+                  std::span<Vertex>   vertices,
+                  std::span<uint32_t> indices,
+                  uint32_t            firstVertex) override;
+
+        /**
+         * \brief Not supported, throws a FloahError. The shape can only be drawn with ShapeVertex vertices.
+         * \param fontMap FontMap.
+         * \param vertices Output vertices.
+         * \param indices Output indices.
+         * \param firstVertex Offset added to each index.
+         */
+        void emit(FontMap&                fontMap,
+                  std::span<CompactVertex> vertices,
+                  std::span<uint32_t>      indices,
+                  uint32_t                 firstVertex) override;
+
+        /**
+         * \brief Write the quad into caller-provided buffers.
+         * \param fontMap FontMap.
+         * \param vertices Output vertices.
+         * \param indices Output indices.
+         * \param firstVertex Offset added to each index.
+         */
+        void emit(FontMap&               fontMap,
+                  std::span<ShapeVertex> vertices,
+                  std::span<uint32_t>    indices,
+                  uint32_t               firstVertex) override;
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Lower bounds of the rectangle.
+         */
+        math::float2 lower;
+
+        /**
+         * \brief Upper bounds of the rectangle.
+         */
+        math::float2 upper;
+
+        /**
+         * \brief Radius of the corners (in pixels). Clamped to half the width and height.
+         */
+        float cornerRadius = 0;
+
+        /**
+         * \brief FillMode.
+         */
+        FillMode fillMode = FillMode::Both;
+
+        /**
+         * \brief Width of the outline. Relative lengths are relative to half the smallest side.
+         */
+        Length margin;
+
+        /**
+         * \brief Vertex color.
+         */
+        math::float4 color = {1, 1, 1, 1};
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Generate.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Write all 4 vertices.
+         * \param vertices Output vertices.
+         */
+        void writeVertices(ShapeVertex* vertices) const;
+
+        /**
+         * \brief Get the outline width based on fillMode and margin.
+         * \return Outline width, or 0 if filled.
+         */
+        [[nodiscard]] float getOutlineWidth() const;
+    };
+}  // namespace floah
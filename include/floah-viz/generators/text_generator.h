@@ -1,5 +1,14 @@
 #pragma once
 
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
@@ -11,6 +20,7 @@
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "floah-viz/vertex.h"
 #include "floah-viz/generators/generator.h"
 
 namespace floah
@@ -34,12 +44,70 @@ namespace floah
 
         TextGenerator& operator=(TextGenerator&&) noexcept = delete;
 
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the range of vertices that was written by the last call to generate. Vertices outside of this
+         * range are identical to what was uploaded before, so renderers that support partial uploads can skip them.
+         * \return Vertex range [first, last).
+         */
+        [[nodiscard]] std::pair<uint32_t, uint32_t> getUpdatedVertexRange() const noexcept;
+
+        /**
+         * \brief Get the FontMap generation at the end of the last call to generate. If the FontMap generation has
+         * changed since, the generated mesh may reference evicted characters and should be regenerated.
+         * \return Generation.
+         */
+        [[nodiscard]] uint64_t getGeneration() const noexcept;
+
         ////////////////////////////////////////////////////////////////
         // Generate.
         ////////////////////////////////////////////////////////////////
 
+        /**
+         * \brief Generate text geometry. When params.mesh is the mesh returned by the previous call and the font map,
+         * position and font size are unchanged, only glyphs that differ from the previous text are regenerated. Glyphs
+         * after a change are shifted instead of regenerated. Buffers keep some slack, so that the mesh keeps the same
+         * size while the text shrinks or grows a little.
+         * \param params Parameters.
+         * \return Mesh.
+         */
         [[nodiscard]] sol::IMesh& generate(Params& params) override;
 
+        using Generator::emit;
+
+        /**
+         * \brief Get the number of vertices and indices that emit writes: 4 vertices and 6 indices per character.
+         * \return Counts.
+         */
+        [[nodiscard]] Counts measure() override;
+
+        /**
+         * \brief Write text geometry into caller-provided buffers. Always generates all glyphs.
+         * \param targetFontMap FontMap.
+         * \param outVertices Output vertices.
+         * \param outIndices Output indices.
+         * \param firstVertex Offset added to each index.
+         */
+        void emit(FontMap&            targetFontMap,
+                  std::span<Vertex>   outVertices,
+                  std::span<uint32_t> outIndices,
+                  uint32_t            firstVertex) override;
+
+        /**
+         * \brief Write geometry in the compact vertex format.
+         * \param targetFontMap FontMap.
+         * \param outVertices Output vertices.
+         * \param outIndices Output indices.
+         * \param firstVertex Offset added to each index.
+         */
+        void emit(FontMap&                targetFontMap,
+                  std::span<CompactVertex> outVertices,
+                  std::span<uint32_t>      outIndices,
+                  uint32_t                 firstVertex) override;
+
         ////////////////////////////////////////////////////////////////
         // Member variables.
         ////////////////////////////////////////////////////////////////
@@ -47,5 +115,104 @@ namespace floah
         std::string text;
 
         math::float2 position;
+
+        /**
+         * \brief Font size (in pixels). If 0, text is rendered at the size the FontMap was generated at. Mostly useful
+         * for distance field FontMaps, which can be rendered at any size.
+         */
+        float fontSize = 0;
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Generate.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Write geometry in any vertex format that has a VertexTraits specialization.
+         * \tparam V Vertex type.
+         * \param targetFontMap FontMap.
+         * \param outVertices Output vertices.
+         * \param outIndices Output indices.
+         * \param firstVertex Offset added to each index.
+         */
+        template<typename V>
+        void emitGeometry(FontMap&            targetFontMap,
+                          std::span<V>        outVertices,
+                          std::span<uint32_t> outIndices,
+                          uint32_t            firstVertex);
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Character codes of the previously generated text.
+         */
+        std::vector<uint32_t> codes;
+
+        /**
+         * \brief Character codes of the text being generated.
+         */
+        std::vector<uint32_t> nextCodes;
+
+        /**
+         * \brief Horizontal pen position before each glyph, plus one for the end of the text.
+         */
+        std::vector<float> pens;
+
+        /**
+         * \brief Metrics of the glyphs being generated.
+         */
+        std::vector<FontMap::Character> glyphs;
+
+        /**
+         * \brief Horizontal pen position before each glyph being appended.
+         */
+        std::vector<float> glyphPens;
+
+        /**
+         * \brief Vertex data, capacity * 4 vertices. Unused quads are collapsed.
+         */
+        std::vector<Vertex> vertices;
+
+        /**
+         * \brief Index data, capacity * 6 indices.
+         */
+        std::vector<uint32_t> indices;
+
+        /**
+         * \brief Number of glyphs that fit in the vertex and index data.
+         */
+        uint32_t capacity = 0;
+
+        /**
+         * \brief Vertex range written by the last call to generate.
+         */
+        std::pair<uint32_t, uint32_t> updatedVertexRange{0, 0};
+
+        /**
+         * \brief Mesh returned by the last call to generate.
+         */
+        sol::IMesh* mesh = nullptr;
+
+        /**
+         * \brief FontMap used by the last call to generate.
+         */
+        const FontMap* fontMap = nullptr;
+
+        /**
+         * \brief Position used by the last call to generate.
+         */
+        math::float2 layoutPosition;
+
+        /**
+         * \brief Metrics scale used by the last call to generate.
+         */
+        float layoutScale = 0;
+
+        /**
+         * \brief FontMap generation at the end of the last call to generate.
+         */
+        uint64_t generation = 0;
     };
 }  // namespace floah
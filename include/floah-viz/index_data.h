@@ -0,0 +1,39 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "sol/mesh/fwd.h"
+
+namespace floah
+{
+    /**
+     * \brief Get the smallest index size that can address all vertices of a mesh.
+     * \param vertexCount Number of vertices.
+     * \return Index size (in bytes). Either sizeof(uint16_t) or sizeof(uint32_t).
+     */
+    [[nodiscard]] size_t getIndexSize(size_t vertexCount) noexcept;
+
+    /**
+     * \brief Add an index buffer to a mesh description and fill it. Indices are narrowed to 16 bits if all vertices can
+     * be addressed with those, halving the size of the index buffer. Otherwise, they are stored as is.
+     * \param desc Mesh description.
+     * \param indices Indices.
+     * \param vertexCount Number of vertices the indices refer to.
+     * \param resource Memory resource used for the narrowed copy of the indices.
+     */
+    void addIndexData(sol::MeshDescription&      desc,
+                      std::span<const uint32_t>  indices,
+                      size_t                     vertexCount,
+                      std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+}  // namespace floah
@@ -0,0 +1,66 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace floah
+{
+    /**
+     * \brief Read-only memory mapping of a whole file.
+     */
+    class MappedFile
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        MappedFile();
+
+        /**
+         * \brief Map a file into memory. Throws a FloahError if the file could not be opened or mapped.
+         * \param filePath Path to file.
+         */
+        explicit MappedFile(const std::filesystem::path& filePath);
+
+        MappedFile(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&&) noexcept;
+
+        ~MappedFile() noexcept;
+
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile& operator=(MappedFile&&) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the mapped file contents.
+         * \return File contents. Empty if nothing is mapped.
+         */
+        [[nodiscard]] std::span<const uint8_t> getData() const noexcept;
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Start of mapping.
+         */
+        const uint8_t* data = nullptr;
+
+        /**
+         * \brief Size of mapping in bytes.
+         */
+        size_t size = 0;
+    };
+}  // namespace floah
@@ -0,0 +1,44 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <cstdint>
+
+namespace floah
+{
+    /**
+     * \brief Per-instance record of an instanced rectangle or circle. Instances are drawn with the unit mesh of their
+     * generator, whose vertices are placed in the vertex shader:
+     *  - position.xy is the vertex position in the unit square [0, 1] (rectangle) or on the unit circle (circle).
+     *  - position.z is 1 for vertices on the inside of the outline, which are moved inwards by margin.
+     *  - position.w is the FillMode bit the vertex belongs to. A vertex should be collapsed if this bit is not set in
+     *    fillMode.
+     */
+    struct ShapeInstance
+    {
+        /**
+         * \brief Lower and upper bounds (lower.x, lower.y, upper.x, upper.y).
+         */
+        std::array<float, 4> bounds{};
+
+        /**
+         * \brief Horizontal and vertical outline width (in pixels).
+         */
+        std::array<float, 2> margin{};
+
+        /**
+         * \brief RGBA8 unorm color.
+         */
+        uint32_t color = 0;
+
+        /**
+         * \brief FillMode bits.
+         */
+        uint32_t fillMode = 0;
+    };
+
+    static_assert(sizeof(ShapeInstance) == 32);
+}  // namespace floah
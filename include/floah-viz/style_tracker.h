@@ -0,0 +1,164 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/flat_map.h"
+#include "floah-viz/stylesheet.h"
+
+namespace floah
+{
+    /**
+     * \brief Tracks which stylesheet values are read by which dependents, such as generators or widgets, and collects
+     * the dependents that are affected by changes into a dirty list. Dependents subscribe to the values they read
+     * through a stylesheet. Setting a value on that stylesheet or on one of its ancestors marks the dependent as dirty,
+     * unless a stylesheet closer to the one it reads through has its own value. Setting the parent of any stylesheet in
+     * the chain marks the dependent as dirty regardless of the key. Stylesheets only notify the tracker they were given
+     * with Stylesheet::setTracker.
+     */
+    class StyleTracker
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Identifier of a dependent, chosen by the caller. E.g. a GeometryBatch handle.
+         */
+        using Dependent = uint32_t;
+
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        StyleTracker();
+
+        StyleTracker(const StyleTracker&) = delete;
+
+        StyleTracker(StyleTracker&&) noexcept = delete;
+
+        ~StyleTracker() noexcept;
+
+        StyleTracker& operator=(const StyleTracker&) = delete;
+
+        StyleTracker& operator=(StyleTracker&&) noexcept = delete;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get all dependents that were marked as dirty since the last call to clearDirty, in the order in which
+         * they were first marked. Each dependent occurs once.
+         * \return List of dependents.
+         */
+        [[nodiscard]] const std::vector<Dependent>& getDirty() const noexcept;
+
+        /**
+         * \brief Returns whether a dependent was marked as dirty since the last call to clearDirty.
+         * \param dependent Dependent.
+         * \return True if dirty.
+         */
+        [[nodiscard]] bool isDirty(Dependent dependent) const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Setters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Subscribe a dependent to a value it reads through a stylesheet.
+         * \tparam T Value type.
+         * \param dependent Dependent.
+         * \param stylesheet Stylesheet the value is read through. Must outlive the subscription.
+         * \param id Value identifier.
+         */
+        template<typename T>
+        void subscribe(const Dependent dependent, const Stylesheet& stylesheet, const PropertyId id)
+        {
+            subscribe(dependent, stylesheet, Stylesheet::getValueKey(hashParameter<T>(), id));
+        }
+
+        /**
+         * \brief Subscribe a dependent to a value it reads through a stylesheet.
+         * \param dependent Dependent.
+         * \param stylesheet Stylesheet the value is read through. Must outlive the subscription.
+         * \param key Value key. See Stylesheet::getValueKey.
+         */
+        void subscribe(Dependent dependent, const Stylesheet& stylesheet, uint64_t key);
+
+        /**
+         * \brief Remove all subscriptions of a dependent. Does not remove it from the dirty list.
+         * \param dependent Dependent.
+         */
+        void unsubscribe(Dependent dependent);
+
+        /**
+         * \brief Clear the dirty list. Call once per frame, after handling all dirty dependents.
+         */
+        void clearDirty() noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Notify.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Mark all dependents of a value that is read through a stylesheet chain containing the changed
+         * stylesheet as dirty. Called by Stylesheet::set.
+         * \param changed Stylesheet on which the value was set.
+         * \param key Value key.
+         */
+        void notify(const Stylesheet& changed, uint64_t key);
+
+        /**
+         * \brief Mark all dependents that read through a stylesheet chain containing the changed stylesheet as dirty.
+         * Called by Stylesheet::setParent.
+         * \param changed Stylesheet of which the parent was set.
+         */
+        void notifyAll(const Stylesheet& changed);
+
+    private:
+        ////////////////////////////////////////////////////////////////
+        // Types.
+        ////////////////////////////////////////////////////////////////
+
+        struct Subscription
+        {
+            Dependent         dependent  = 0;
+            const Stylesheet* stylesheet = nullptr;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        // Dirty.
+        ////////////////////////////////////////////////////////////////
+
+        void markDirty(Dependent dependent);
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Subscriptions by value key.
+         */
+        FlatMap<std::vector<Subscription>, uint64_t> subscriptions;
+
+        /**
+         * \brief Dirty dependents, in the order in which they were marked.
+         */
+        std::vector<Dependent> dirty;
+
+        /**
+         * \brief Set of dirty dependents, to skip duplicates.
+         */
+        FlatMap<bool> dirtySet;
+    };
+}  // namespace floah
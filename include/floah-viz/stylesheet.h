@@ -5,13 +5,29 @@
 ////////////////////////////////////////////////////////////////
 
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/flat_map.h"
 
 namespace floah
 {
+    class StyleTracker;
+
     /**
      * \brief Hash an uint32_t. (Thomas Wang, Jan 1997)
      * \param s Value.
@@ -62,39 +78,33 @@ namespace floah
     }
 
     /**
-     * \brief Hash a static string.
+     * \brief Hash a string with 32-bit FNV-1a. Gives the same result as hash(const char*), but can also be evaluated at
+     * runtime. Unlike hash(const char (&)[N]), the result depends on the order of the characters.
      * \param str String.
      * \return Hash.
      */
-    consteval uint32_t hash(const char* str)
+    [[nodiscard]] constexpr uint32_t hashString(const std::string_view str) noexcept
     {
-        size_t N = 0;
-        while (str[N] != '\0') N++;
-
-        auto value = std::numeric_limits<uint32_t>::max();
+        constexpr uint32_t fnv_offset_basis = 2166136261u;
+        constexpr uint32_t fnv_prime        = 16777619u;
 
-        // Hash characters in multiples of 4.
-        for (size_t i = 0; i < N / 4; i++)
+        auto value = fnv_offset_basis;
+        for (const auto c : str)
         {
-            const auto c0 = static_cast<uint32_t>(*(str + i * 4 + 0)) << 24;
-            const auto c1 = static_cast<uint32_t>(*(str + i * 4 + 1)) << 16;
-            const auto c2 = static_cast<uint32_t>(*(str + i * 4 + 2)) << 8;
-            const auto c3 = static_cast<uint32_t>(*(str + i * 4 + 3)) << 0;
-            value         = value ^ hash(c0 | c1 | c2 | c3);
-        }
-
-        // Hash 0-3 remaining characters.
-        if (const auto remainder = N % 4; remainder > 0)
-        {
-            const auto c0 = static_cast<uint32_t>(*(str + N - remainder)) << 24;
-            const auto c1 = remainder > 1 ? static_cast<uint32_t>(*(str + N - remainder + 1)) << 16 : 0;
-            const auto c2 = remainder > 2 ? static_cast<uint32_t>(*(str + N - remainder + 2)) << 8 : 0;
-            value         = value ^ hash(c0 | c1 | c2);
+            value ^= static_cast<uint8_t>(c);
+            value *= fnv_prime;
         }
 
         return value;
     }
 
+    /**
+     * \brief Hash a static string.
+     * \param str String.
+     * \return Hash.
+     */
+    consteval uint32_t hash(const char* str) { return hashString(str); }
+
     /**
      * \brief Hash a type name.
      * \tparam T Type.
@@ -110,6 +120,95 @@ namespace floah
 #endif
     }
 
+    /**
+     * \brief Identifier of a stylesheet property, derived from its name. Declare constexpr identifiers for frequently
+     * used properties, so that names are hashed at compile time instead of on every lookup. Distinct names are assumed
+     * to have distinct hashes. In debug builds, identifiers constructed from runtime strings are checked against all
+     * names seen before, and a collision throws.
+     */
+    class PropertyId
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        constexpr PropertyId() noexcept = default;
+
+        /**
+         * \brief Construct an identifier from a string literal. Always evaluated at compile time.
+         * \tparam N String length.
+         * \param name Property name.
+         */
+        template<size_t N>
+        explicit consteval PropertyId(const char (&name)[N]) noexcept : value(hashString(name))
+        {
+        }
+
+        /**
+         * \brief Construct an identifier from a runtime string.
+         * \param name Property name.
+         */
+        explicit constexpr PropertyId(const std::string_view name) : value(hashString(name))
+        {
+#ifndef NDEBUG
+            if (!std::is_constant_evaluated()) registerName(name, value);
+#endif
+        }
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the hashed name.
+         * \return Hash.
+         */
+        [[nodiscard]] constexpr uint32_t get() const noexcept { return value; }
+
+        /**
+         * \brief Construct an identifier from a hashed name.
+         * \param hash Hash.
+         * \return Identifier.
+         */
+        [[nodiscard]] static constexpr PropertyId fromHash(const uint32_t hash) noexcept
+        {
+            PropertyId id;
+            id.value = hash;
+            return id;
+        }
+
+        [[nodiscard]] constexpr bool operator==(const PropertyId&) const noexcept = default;
+
+    private:
+        /**
+         * \brief Remember which name produced a hash. Throws if a different name produced the same hash before. Always
+         * exported, so that consumers built without NDEBUG link against a library built with it. Does nothing if the
+         * library itself was built with NDEBUG.
+         * \param name Property name.
+         * \param hash Hash of name.
+         */
+        static void registerName(std::string_view name, uint32_t hash);
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        uint32_t value = 0;
+    };
+
+    /**
+     * \brief Value types that a Stylesheet stores inline in a packed byte array instead of in a separate map per type.
+     */
+    template<typename T>
+    concept PackedStyleValue = std::is_trivially_copyable_v<T> && alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    /**
+     * \brief Set of named values of arbitrary types, with an optional parent stylesheet to fall back to. Copies share
+     * their value maps. Setting a value in a map that is shared stores it in a sparse override layer instead, so
+     * copying a stylesheet and tweaking a few values costs memory proportional to the number of tweaks. Values of
+     * trivially copyable types are not stored in a map per type, but together in one packed byte array.
+     */
     class Stylesheet
     {
     public:
@@ -117,6 +216,11 @@ namespace floah
         // Types.
         ////////////////////////////////////////////////////////////////
 
+        /**
+         * \brief Table of pointers to values, keyed by value type and PropertyId. See getValueKey.
+         */
+        using ValueTable = FlatMap<const void*, uint64_t>;
+
         struct BaseMap
         {
             BaseMap() = default;
@@ -132,14 +236,84 @@ namespace floah
             BaseMap& operator=(BaseMap&&) = default;
 
             [[nodiscard]] virtual std::unique_ptr<BaseMap> clone() const = 0;
+
+            /**
+             * \brief Add pointers to all values to a table. Values that are already in the table are not replaced.
+             * \param type Hashed value type.
+             * \param table Table.
+             */
+            virtual void flatten(uint32_t type, ValueTable& table) const = 0;
+
+            /**
+             * \brief Returns whether there is a value for a property.
+             * \param id Hashed property identifier.
+             * \return True if present.
+             */
+            [[nodiscard]] virtual bool contains(uint32_t id) const noexcept = 0;
         };
 
         using BaseMapPtr = std::unique_ptr<BaseMap>;
 
+        using SharedMapPtr = std::shared_ptr<BaseMap>;
+
+        /**
+         * \brief Values of all PackedStyleValue types, stored inline in a single byte array.
+         */
+        struct PackedValues
+        {
+            /**
+             * \brief Offset of each value into data, by value key. See getValueKey.
+             */
+            FlatMap<uint32_t, uint64_t> offsets;
+
+            std::vector<std::byte> data;
+
+            /**
+             * \brief Find a value.
+             * \tparam T Value type.
+             * \param key Value key.
+             * \return Value or nullptr.
+             */
+            template<PackedStyleValue T>
+            [[nodiscard]] const T* find(const uint64_t key) const noexcept
+            {
+                const auto* offset = offsets.find(key);
+                return offset ? reinterpret_cast<const T*>(data.data() + *offset) : nullptr;
+            }
+
+            /**
+             * \brief Set a value. A new value is appended to data, at an offset aligned for its type.
+             * \tparam T Value type.
+             * \param key Value key.
+             * \param value Value.
+             */
+            template<PackedStyleValue T>
+            void set(const uint64_t key, const T& value)
+            {
+                auto* offset = offsets.find(key);
+                if (!offset)
+                {
+                    const auto aligned = (data.size() + alignof(T) - 1) / alignof(T) * alignof(T);
+                    data.resize(aligned + sizeof(T));
+                    offset = &offsets.insertOrAssign(key, static_cast<uint32_t>(aligned));
+                }
+                std::memcpy(data.data() + *offset, &value, sizeof(T));
+            }
+
+            /**
+             * \brief Add pointers to all values to a table. Values that are already in the table are not replaced.
+             * \param table Table.
+             */
+            void flatten(ValueTable& table) const;
+        };
+
         template<typename T>
         struct Map : BaseMap
         {
-            std::unordered_map<std::string, T> map;
+            /**
+             * \brief Values by PropertyId.
+             */
+            FlatMap<T> map;
 
             Map() = default;
 
@@ -154,6 +328,15 @@ namespace floah
             Map& operator=(Map&&) = default;
 
             [[nodiscard]] BaseMapPtr clone() const override { return std::make_unique<Map<T>>(*this); }
+
+            void flatten(const uint32_t type, ValueTable& table) const override
+            {
+                map.forEach([&](const uint32_t id, const T& value) {
+                    table.tryEmplace(getValueKey(type, PropertyId::fromHash(id)), &value);
+                });
+            }
+
+            [[nodiscard]] bool contains(const uint32_t id) const noexcept override { return map.find(id) != nullptr; }
         };
 
         ////////////////////////////////////////////////////////////////
@@ -188,6 +371,38 @@ namespace floah
          */
         [[nodiscard]] const Stylesheet* getParent() const noexcept;
 
+        /**
+         * \brief Get the version. It changes whenever a value or the parent is set. Versions are unique across all
+         * stylesheets, so a (stylesheet, version) pair identifies a single state even if the stylesheet is destroyed
+         * and another one is created at the same address.
+         * \return Version.
+         */
+        [[nodiscard]] uint64_t getVersion() const noexcept;
+
+        /**
+         * \brief Get the tracker that is notified of changes to this stylesheet.
+         * \return StyleTracker or nullptr.
+         */
+        [[nodiscard]] StyleTracker* getTracker() const noexcept;
+
+        /**
+         * \brief Returns whether this stylesheet itself has a value, ignoring the parent.
+         * \param key Value key. See getValueKey.
+         * \return True if present.
+         */
+        [[nodiscard]] bool contains(uint64_t key) const noexcept;
+
+        /**
+         * \brief Combine a hashed value type and property identifier into a key for a ValueTable.
+         * \param type Hashed value type.
+         * \param id Property identifier.
+         * \return Key.
+         */
+        [[nodiscard]] static constexpr uint64_t getValueKey(const uint32_t type, const PropertyId id) noexcept
+        {
+            return static_cast<uint64_t>(type) << 32 | id.get();
+        }
+
         ////////////////////////////////////////////////////////////////
         // Setters.
         ////////////////////////////////////////////////////////////////
@@ -196,12 +411,37 @@ namespace floah
          * \brief Set the parent stylesheet from which values will be retrieved if this stylesheet does not have it.
          * \param stylesheet Parent or nullptr.
          */
-        void setParent(Stylesheet* stylesheet) noexcept;
+        void setParent(Stylesheet* stylesheet);
+
+        /**
+         * \brief Set the tracker that is notified whenever a value or the parent of this stylesheet is set. A
+         * stylesheet without a tracker inherits the tracker of the parent passed to setParent.
+         * \param styleTracker StyleTracker or nullptr. Must outlive this stylesheet.
+         */
+        void setTracker(StyleTracker* styleTracker) noexcept;
 
         ////////////////////////////////////////////////////////////////
         // Access.
         ////////////////////////////////////////////////////////////////
 
+        /**
+         * \brief Set a value.
+         * \tparam T Value type.
+         * \param id Value identifier.
+         * \param value Value.
+         */
+        template<std::copyable T>
+        void set(const PropertyId id, T&& value)
+        {
+            const auto key = getValueKey(hashParameter<T>(), id);
+            if constexpr (PackedStyleValue<T>)
+                getWritablePackedValues(key).set(key, value);
+            else
+                getWritableMap<T>(id).insertOrAssign(id.get(), std::forward<T>(value));
+            version = nextVersion();
+            if (tracker) notifyTracker(key);
+        }
+
         /**
          * \brief Set a value.
          * \tparam T Value type.
@@ -211,13 +451,22 @@ namespace floah
         template<std::copyable T>
         void set(const std::string& name, T&& value)
         {
-            constexpr auto key = hashParameter<T>();
+            set(PropertyId(name), std::forward<T>(value));
+        }
 
-            auto it = maps.find(key);
-            if (it == maps.end()) it = maps.try_emplace(key, std::make_unique<Map<T>>()).first;
+        /**
+         * \brief Retrieve a value.
+         * \tparam T Value type.
+         * \param id Value identifier.
+         * \return Value or empty if it does not exist.
+         */
+        template<typename T>
+        [[nodiscard]] std::optional<T> get(const PropertyId id) const
+        {
+            for (const auto* sheet = this; sheet; sheet = sheet->parent)
+                if (const auto* value = sheet->find<T>(id)) return *value;
 
-            auto& map = static_cast<Map<T>&>(*it->second).map;
-            map.insert_or_assign(name, std::forward<T>(value));
+            return {};
         }
 
         /**
@@ -229,50 +478,329 @@ namespace floah
         template<typename T>
         [[nodiscard]] std::optional<T> get(const std::string& name) const
         {
-            constexpr auto key = hashParameter<T>();
+            return get<T>(PropertyId(name));
+        }
 
-            auto it = maps.find(key);
-            if (it == maps.end())
-            {
-                if (parent) return parent->get<T>(name);
-                return {};
-            }
+        /**
+         * \brief Retrieve a value.
+         * \tparam T Value type.
+         * \param id Value identifier.
+         * \param defaultValue Value to return if a value with the given identifier does not exist.
+         * \return Value.
+         */
+        template<typename T>
+        [[nodiscard]] T get(const PropertyId id, T defaultValue) const
+        {
+            const auto val = get<T>(id);
+            if (val) return *val;
+            return defaultValue;
+        }
+
+        /**
+         * \brief Retrieve a value.
+         * \tparam T Value type.
+         * \param name Value name.
+         * \param defaultValue Value to return if a value with the given name does not exist.
+         * \return Value.
+         */
+        template<typename T>
+        [[nodiscard]] T get(const std::string& name, T defaultValue) const
+        {
+            return get<T>(PropertyId(name), std::move(defaultValue));
+        }
 
-            const auto& map = static_cast<Map<T>&>(*it->second).map;
+    private:
+        friend class FlattenedStylesheet;
 
-            auto it2 = map.find(name);
-            if (it2 == map.end())
+        ////////////////////////////////////////////////////////////////
+        // Maps.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Find the map holding values of a type.
+         * \tparam T Value type.
+         * \tparam P Map pointer type.
+         * \param from Maps by hashed value type.
+         * \return Map or nullptr if no value of this type was set.
+         */
+        template<typename T, typename P>
+        [[nodiscard]] static FlatMap<T>* findMap(const FlatMap<P>& from) noexcept
+        {
+            const auto* map = from.find(hashParameter<T>());
+            return map ? &static_cast<Map<T>&>(**map).map : nullptr;
+        }
+
+        /**
+         * \brief Find a value in this stylesheet only. Overrides hide shared values.
+         * \tparam T Value type.
+         * \param id Value identifier.
+         * \return Value or nullptr.
+         */
+        template<typename T>
+        [[nodiscard]] const T* find(const PropertyId id) const noexcept
+        {
+            if constexpr (PackedStyleValue<T>)
             {
-                if (parent) return parent->get<T>(name);
-                return {};
+                const auto key = getValueKey(hashParameter<T>(), id);
+                if (const auto* value = packedOverrides.find<T>(key)) return value;
+                return packed ? packed->find<T>(key) : nullptr;
             }
 
-            return it2->second;
+            if (const auto* map = findMap<T>(overrides))
+                if (const auto* value = map->find(id.get())) return value;
+            if (const auto* map = findMap<T>(maps)) return map->find(id.get());
+            return nullptr;
         }
 
         /**
-         * \brief Retrieve a value.
+         * \brief Get the map a value must be written to. That is the shared map if no other stylesheet holds it, or
+         * the override layer if the map is shared or the value was overridden before.
          * \tparam T Value type.
-         * \param name Value name.
-         * \param defaultValue Value to return if a value with the given name does not exist.
+         * \param id Value identifier.
+         * \return Map.
+         */
+        template<typename T>
+        [[nodiscard]] FlatMap<T>& getWritableMap(const PropertyId id)
+        {
+            constexpr auto type = hashParameter<T>();
+
+            auto* overrideMap = findMap<T>(overrides);
+            if (overrideMap && overrideMap->find(id.get())) return *overrideMap;
+
+            auto& shared = maps.tryEmplace(type, nullptr);
+            if (!shared) shared = std::make_shared<Map<T>>();
+            if (shared.use_count() == 1) return static_cast<Map<T>&>(*shared).map;
+
+            // Map is shared with copies of this stylesheet. Store the value in the sparse override layer instead of
+            // copying the whole map.
+            auto& map = overrides.tryEmplace(type, nullptr);
+            if (!map) map = std::make_unique<Map<T>>();
+            return static_cast<Map<T>&>(*map).map;
+        }
+
+        /**
+         * \brief Get the packed values a value must be written to. Follows the same rules as getWritableMap.
+         * \param key Value key.
+         * \return Packed values.
+         */
+        [[nodiscard]] PackedValues& getWritablePackedValues(uint64_t key);
+
+        /**
+         * \brief Notify the tracker that a value was set.
+         * \param key Value key.
+         */
+        void notifyTracker(uint64_t key);
+
+        /**
+         * \brief Get a new, globally unique version.
+         * \return Version.
+         */
+        [[nodiscard]] static uint64_t nextVersion() noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Member variables.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Value maps by hashed value type. Copies of a stylesheet share these maps.
+         */
+        FlatMap<SharedMapPtr> maps;
+
+        /**
+         * \brief Values set while the map of their type was shared, by hashed value type. Owned by this stylesheet.
+         */
+        FlatMap<BaseMapPtr> overrides;
+
+        /**
+         * \brief Values of PackedStyleValue types. Copies of a stylesheet share these values.
+         */
+        std::shared_ptr<PackedValues> packed;
+
+        /**
+         * \brief Values of PackedStyleValue types that were set while the packed values were shared.
+         */
+        PackedValues packedOverrides;
+
+        Stylesheet* parent = nullptr;
+
+        StyleTracker* tracker = nullptr;
+
+        uint64_t version = nextVersion();
+    };
+
+    /**
+     * \brief Binds a member of a style schema to a property.
+     * \tparam S Schema type.
+     * \tparam T Value type.
+     */
+    template<typename S, typename T>
+    struct StyleField
+    {
+        T S::*member;
+
+        PropertyId id;
+    };
+
+    /**
+     * \brief Struct of style values that can be resolved in one go. Must have a static constexpr tuple of StyleFields
+     * named style_fields. Members that are not found in the stylesheet keep their default value, e.g.:
+     *
+     * struct ButtonStyle
+     * {
+     *     float padding = 4;
+     *     static constexpr std::tuple style_fields{StyleField{&ButtonStyle::padding, PropertyId("padding")}};
+     * };
+     */
+    template<typename S>
+    concept StyleSchema = std::default_initializable<S> && std::copyable<S> && requires { S::style_fields; };
+
+    /**
+     * \brief Resolves a stylesheet and all of its ancestors into a single table, so that a lookup takes one probe no
+     * matter how deep the parent chain is. The table is rebuilt on the first lookup after the version of any
+     * stylesheet in the chain changed, or after the chain itself changed. Checking for that only compares versions.
+     */
+    class FlattenedStylesheet
+    {
+    public:
+        ////////////////////////////////////////////////////////////////
+        // Constructors.
+        ////////////////////////////////////////////////////////////////
+
+        FlattenedStylesheet() = delete;
+
+        /**
+         * \brief Construct a new flattened view. Does not yet build the table.
+         * \param sheet Stylesheet. Must outlive this object.
+         */
+        explicit FlattenedStylesheet(const Stylesheet& sheet);
+
+        FlattenedStylesheet(const FlattenedStylesheet&) = delete;
+
+        FlattenedStylesheet(FlattenedStylesheet&&) noexcept;
+
+        ~FlattenedStylesheet() noexcept;
+
+        FlattenedStylesheet& operator=(const FlattenedStylesheet&) = delete;
+
+        FlattenedStylesheet& operator=(FlattenedStylesheet&&) noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Getters.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Get the stylesheet.
+         * \return Stylesheet.
+         */
+        [[nodiscard]] const Stylesheet& getStylesheet() const noexcept;
+
+        /**
+         * \brief Returns whether the table matches the current state of the stylesheet and its ancestors.
+         * \return True if up to date.
+         */
+        [[nodiscard]] bool isValid() const noexcept;
+
+        ////////////////////////////////////////////////////////////////
+        // Access.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Retrieve a value. Rebuilds the table if it is out of date.
+         * \tparam T Value type.
+         * \param id Value identifier.
+         * \return Value or empty if it does not exist.
+         */
+        template<typename T>
+        [[nodiscard]] std::optional<T> get(const PropertyId id)
+        {
+            if (!isValid()) update();
+            const auto* value = table.find(Stylesheet::getValueKey(hashParameter<T>(), id));
+            if (!value) return {};
+            return *static_cast<const T*>(*value);
+        }
+
+        /**
+         * \brief Retrieve a value. Rebuilds the table if it is out of date.
+         * \tparam T Value type.
+         * \param id Value identifier.
+         * \param defaultValue Value to return if a value with the given identifier does not exist.
          * \return Value.
          */
         template<typename T>
-        [[nodiscard]] T get(const std::string& name, T defaultValue) const
+        [[nodiscard]] T get(const PropertyId id, T defaultValue)
         {
-            const auto val = get<T>(name);
+            const auto val = get<T>(id);
             if (val) return *val;
             return defaultValue;
         }
 
+        /**
+         * \brief Resolve all fields of a style schema. The result is cached until the table is rebuilt, so all users of
+         * this object share a single resolution per schema.
+         * \tparam S Schema type.
+         * \return Resolved style. Remains valid until the next rebuild of the table.
+         */
+        template<StyleSchema S>
+        [[nodiscard]] const S& resolve()
+        {
+            if (!isValid()) update();
+
+            auto& style = resolved.tryEmplace(hashParameter<S>(), nullptr);
+            if (!style)
+            {
+                auto result = std::make_shared<S>();
+                std::apply([&](const auto&... field) { (resolveField(*result, field), ...); }, S::style_fields);
+                style = std::move(result);
+            }
+
+            return *static_cast<const S*>(style.get());
+        }
+
+        /**
+         * \brief Rebuild the table from the current state of the stylesheet and its ancestors.
+         */
+        void update();
+
     private:
+        ////////////////////////////////////////////////////////////////
+        // Resolve.
+        ////////////////////////////////////////////////////////////////
+
+        /**
+         * \brief Look up a single field of a style schema. Leaves the member unchanged if there is no value.
+         * \tparam S Schema type.
+         * \tparam T Value type.
+         * \param style Style.
+         * \param field Field.
+         */
+        template<typename S, typename T>
+        void resolveField(S& style, const StyleField<S, T>& field) const noexcept(std::is_nothrow_copy_assignable_v<T>)
+        {
+            if (const auto* value = table.find(Stylesheet::getValueKey(hashParameter<T>(), field.id)))
+                style.*field.member = *static_cast<const T*>(*value);
+        }
+
         ////////////////////////////////////////////////////////////////
         // Member variables.
         ////////////////////////////////////////////////////////////////
 
-        std::unordered_map<uint32_t, BaseMapPtr> maps;
+        const Stylesheet* stylesheet = nullptr;
 
-        Stylesheet* parent = nullptr;
+        /**
+         * \brief Pointers to the values of all stylesheets in the chain. Values of a stylesheet hide those of its
+         * ancestors.
+         */
+        Stylesheet::ValueTable table;
+
+        /**
+         * \brief (stylesheet, version) pairs of the chain the table was built from, starting at the stylesheet itself.
+         */
+        std::vector<std::pair<const Stylesheet*, uint64_t>> chain;
+
+        /**
+         * \brief Resolved styles by hashed schema type. Cleared when the table is rebuilt.
+         */
+        FlatMap<std::shared_ptr<void>> resolved;
     };
 
     using StylesheetPtr=std::unique_ptr<Stylesheet>;
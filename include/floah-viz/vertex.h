@@ -1,5 +1,14 @@
 #pragma once
 
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
@@ -14,4 +23,132 @@ namespace floah
         math::float4 color;
         math::float2 uv;
     };
-}
+
+    /**
+     * \brief Packed vertex for 2D geometry. Color is stored as RGBA8 unorm, uv as RG16 unorm.
+     */
+    struct CompactVertex
+    {
+        std::array<float, 2>    position{};
+        uint32_t                color = 0;
+        std::array<uint16_t, 2> uv{};
+    };
+
+    static_assert(sizeof(CompactVertex) == 16);
+
+    /**
+     * \brief Vertex of a quad that is shaded with a signed distance function of a rounded rectangle. All shape
+     * parameters are repeated for each vertex, so that shapes do not need any other per-shape data.
+     */
+    struct ShapeVertex
+    {
+        /**
+         * \brief Position of the quad corner.
+         */
+        math::float2 position;
+
+        /**
+         * \brief Position relative to the center of the shape. Interpolated, evaluate the distance function at this
+         * point.
+         */
+        math::float2 local;
+
+        /**
+         * \brief Half of the width and height of the shape.
+         */
+        math::float2 halfSize;
+
+        /**
+         * \brief Radius of the corners. A shape with equal width and height and a corner radius of half the width is a
+         * circle.
+         */
+        float cornerRadius = 0;
+
+        /**
+         * \brief Width of the outline, or 0 if the shape is filled.
+         */
+        float outlineWidth = 0;
+
+        math::float4 color;
+    };
+
+    /**
+     * \brief Convert a float in the range [0, 1] to an 8-bit unorm value. Values outside of the range are clamped.
+     * \param f Value.
+     * \return Unorm value.
+     */
+    [[nodiscard]] inline uint32_t packUnorm8(const float f)
+    {
+        return static_cast<uint32_t>(std::lround(std::clamp(f, 0.0f, 1.0f) * 255.0f));
+    }
+
+    /**
+     * \brief Convert a color to RGBA8 unorm, with red in the lowest byte.
+     * \param color Color.
+     * \return Packed color.
+     */
+    [[nodiscard]] inline uint32_t packColor(const math::float4& color)
+    {
+        return packUnorm8(color.x) | packUnorm8(color.y) << 8 | packUnorm8(color.z) << 16 | packUnorm8(color.w) << 24;
+    }
+
+    /**
+     * \brief Convert a float in the range [0, 1] to a 16-bit unorm value. Values outside of the range are clamped.
+     * \param f Value.
+     * \return Unorm value.
+     */
+    [[nodiscard]] inline uint16_t packUnorm16(const float f)
+    {
+        return static_cast<uint16_t>(std::lround(std::clamp(f, 0.0f, 1.0f) * 65535.0f));
+    }
+
+    /**
+     * \brief Describes how generators write a vertex format. Generators are instantiated for each format that has a
+     * specialization.
+     * \tparam T Vertex type.
+     */
+    template<typename T>
+    struct VertexTraits;
+
+    template<>
+    struct VertexTraits<Vertex>
+    {
+        /**
+         * \brief Create a vertex.
+         * \param position Position.
+         * \param color Color.
+         * \param uv Texture coordinates.
+         * \return Vertex.
+         */
+        [[nodiscard]] static Vertex
+          create(const math::float2 position, const math::float4& color, const math::float2 uv) noexcept
+        {
+            Vertex v;
+            v.position = math::float4(position.x, position.y, 0.0f, 0.0f);
+            v.color    = color;
+            v.uv       = uv;
+            return v;
+        }
+    };
+
+    template<>
+    struct VertexTraits<CompactVertex>
+    {
+        /**
+         * \brief Create a vertex.
+         * \param position Position.
+         * \param color Color.
+         * \param uv Texture coordinates.
+         * \return Vertex.
+         */
+        [[nodiscard]] static CompactVertex
+          create(const math::float2 position, const math::float4& color, const math::float2 uv) noexcept
+        {
+            CompactVertex v;
+            v.position = {position.x, position.y};
+            v.color    = packColor(color);
+            v.uv       = {packUnorm16(uv.x), packUnorm16(uv.y)};
+            return v;
+        }
+    };
+}  // namespace floah
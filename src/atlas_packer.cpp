@@ -0,0 +1,213 @@
+#include "floah-viz/atlas_packer.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <limits>
+#include <numeric>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-common/floah_error.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    AtlasPacker::AtlasPacker() = default;
+
+    AtlasPacker::AtlasPacker(const math::uint2 imageSize, const uint32_t rectPadding) :
+        size(imageSize), padding(rectPadding)
+    {
+        clear();
+    }
+
+    AtlasPacker::AtlasPacker(const AtlasPacker&) = default;
+
+    AtlasPacker::AtlasPacker(AtlasPacker&&) noexcept = default;
+
+    AtlasPacker::~AtlasPacker() noexcept = default;
+
+    AtlasPacker& AtlasPacker::operator=(const AtlasPacker&) = default;
+
+    AtlasPacker& AtlasPacker::operator=(AtlasPacker&&) noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    math::uint2 AtlasPacker::getImageSize() const noexcept { return size; }
+
+    uint64_t AtlasPacker::getUsedArea() const noexcept { return usedArea; }
+
+    ////////////////////////////////////////////////////////////////
+    // Packing.
+    ////////////////////////////////////////////////////////////////
+
+    void AtlasPacker::clear()
+    {
+        usedArea = 0;
+        skyline.clear();
+        // Padding is only needed between rectangles, so pretend the image is a bit larger.
+        skyline.emplace_back(Node{.x = 0, .y = 0, .width = size.x + padding});
+    }
+
+    std::optional<math::uint2> AtlasPacker::insert(const math::uint2 rectSize)
+    {
+        if (rectSize.x == 0 || rectSize.y == 0) return math::uint2(0, 0);
+
+        const uint32_t w       = rectSize.x + padding;
+        const uint32_t h       = rectSize.y + padding;
+        const uint32_t extentX = size.x + padding;
+        const uint32_t extentY = size.y + padding;
+
+        // Find the segment where the rectangle ends up lowest. On a tie, prefer the narrowest segment.
+        size_t   bestIndex  = skyline.size();
+        uint32_t bestBottom = std::numeric_limits<uint32_t>::max();
+        uint32_t bestWidth  = std::numeric_limits<uint32_t>::max();
+        uint32_t bestY      = 0;
+        for (size_t i = 0; i < skyline.size(); i++)
+        {
+            if (skyline[i].x + w > extentX) break;
+
+            // Rectangle rests on the highest segment it spans.
+            uint32_t y         = 0;
+            uint32_t remaining = w;
+            bool     fit       = true;
+            for (size_t j = i; remaining > 0; j++)
+            {
+                y = std::max(y, skyline[j].y);
+                if (y + h > extentY)
+                {
+                    fit = false;
+                    break;
+                }
+                remaining -= std::min(remaining, skyline[j].width);
+            }
+
+            if (!fit) continue;
+            if (y + h < bestBottom || (y + h == bestBottom && skyline[i].width < bestWidth))
+            {
+                bestIndex  = i;
+                bestBottom = y + h;
+                bestWidth  = skyline[i].width;
+                bestY      = y;
+            }
+        }
+
+        if (bestIndex == skyline.size()) return {};
+
+        // Insert new segment on top of the rectangle.
+        const auto x = skyline[bestIndex].x;
+        skyline.insert(skyline.begin() + static_cast<ptrdiff_t>(bestIndex), Node{.x = x, .y = bestBottom, .width = w});
+
+        // Shrink or remove segments that are now covered.
+        for (size_t i = bestIndex + 1; i < skyline.size();)
+        {
+            const auto& prev = skyline[i - 1];
+            auto&       node = skyline[i];
+            if (node.x >= prev.x + prev.width) break;
+
+            const auto shrink = prev.x + prev.width - node.x;
+            if (node.width <= shrink)
+            {
+                skyline.erase(skyline.begin() + static_cast<ptrdiff_t>(i));
+                continue;
+            }
+
+            node.x += shrink;
+            node.width -= shrink;
+            break;
+        }
+
+        // Merge neighbouring segments at the same height.
+        for (size_t i = 1; i < skyline.size();)
+        {
+            if (skyline[i - 1].y == skyline[i].y)
+            {
+                skyline[i - 1].width += skyline[i].width;
+                skyline.erase(skyline.begin() + static_cast<ptrdiff_t>(i));
+            }
+            else
+                i++;
+        }
+
+        usedArea += static_cast<uint64_t>(rectSize.x) * rectSize.y;
+        return math::uint2(x, bestY);
+    }
+
+    AtlasPacker::Result AtlasPacker::pack(const std::vector<math::uint2>& sizes,
+                                          const uint32_t                  rectPadding,
+                                          const math::uint2               maxImageSize)
+    {
+        // Insert tallest rectangles first, then widest.
+        std::vector<size_t> order(sizes.size());
+        std::iota(order.begin(), order.end(), static_cast<size_t>(0));
+        std::ranges::stable_sort(order, [&sizes](const size_t lhs, const size_t rhs) {
+            if (sizes[lhs].y != sizes[rhs].y) return sizes[lhs].y > sizes[rhs].y;
+            return sizes[lhs].x > sizes[rhs].x;
+        });
+
+        // Start with the smallest power-of-two image that can hold the largest rectangle and the total area.
+        uint64_t    area = 0;
+        math::uint2 imageSize(1, 1);
+        for (const auto& s : sizes)
+        {
+            if (s.x == 0 || s.y == 0) continue;
+            area += static_cast<uint64_t>(s.x + rectPadding) * (s.y + rectPadding);
+            imageSize.x = std::max(imageSize.x, std::bit_ceil(s.x));
+            imageSize.y = std::max(imageSize.y, std::bit_ceil(s.y));
+        }
+
+        // Grow the smaller dimension, so that the image stays close to square.
+        const auto grow = [&imageSize, &maxImageSize] {
+            if ((imageSize.x <= imageSize.y && imageSize.x < maxImageSize.x) || imageSize.y >= maxImageSize.y)
+                imageSize.x *= 2;
+            else
+                imageSize.y *= 2;
+        };
+        while (static_cast<uint64_t>(imageSize.x) * imageSize.y < area) grow();
+
+        Result result;
+        result.positions.resize(sizes.size());
+        while (true)
+        {
+            if (imageSize.x > maxImageSize.x || imageSize.y > maxImageSize.y)
+                throw FloahError(std::format("Could not pack {} rectangles into an image of at most {}x{} pixels.",
+                                             sizes.size(),
+                                             maxImageSize.x,
+                                             maxImageSize.y));
+
+            AtlasPacker packer(imageSize, rectPadding);
+            bool        fit = true;
+            for (const auto i : order)
+            {
+                const auto pos = packer.insert(sizes[i]);
+                if (!pos)
+                {
+                    fit = false;
+                    break;
+                }
+                result.positions[i] = *pos;
+            }
+
+            if (fit)
+            {
+                result.imageSize  = imageSize;
+                result.efficiency = static_cast<float>(static_cast<double>(packer.getUsedArea()) /
+                                                       (static_cast<double>(imageSize.x) * imageSize.y));
+                return result;
+            }
+
+            grow();
+        }
+    }
+}  // namespace floah
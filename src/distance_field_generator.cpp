@@ -0,0 +1,117 @@
+#include "floah-viz/distance_field_generator.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    /**
+     * \brief Squared distance of a pixel that has no feature within range.
+     */
+    constexpr float far_away = 1e20f;
+}  // namespace
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    DistanceFieldGenerator::DistanceFieldGenerator() = default;
+
+    DistanceFieldGenerator::DistanceFieldGenerator(const DistanceFieldGenerator&) = default;
+
+    DistanceFieldGenerator::DistanceFieldGenerator(DistanceFieldGenerator&&) noexcept = default;
+
+    DistanceFieldGenerator::~DistanceFieldGenerator() noexcept = default;
+
+    DistanceFieldGenerator& DistanceFieldGenerator::operator=(const DistanceFieldGenerator&) = default;
+
+    DistanceFieldGenerator& DistanceFieldGenerator::operator=(DistanceFieldGenerator&&) noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Generate.
+    ////////////////////////////////////////////////////////////////
+
+    void DistanceFieldGenerator::generate(const uint8_t*           bitmap,
+                                          const math::uint2        bitmapSize,
+                                          const size_t             pitch,
+                                          const uint32_t           spread,
+                                          const std::span<uint8_t> out)
+    {
+        const math::uint2 size(bitmapSize.x + 2 * spread, bitmapSize.y + 2 * spread);
+        const size_t      count = static_cast<size_t>(size.x) * size.y;
+
+        // Mark inside and outside pixels as features for the respective transforms. Padding is outside.
+        inside.assign(count, far_away);
+        outside.assign(count, 0.0f);
+        for (uint32_t y = 0; y < bitmapSize.y; y++)
+        {
+            const auto* src = bitmap + y * pitch;
+            auto*       in  = inside.data() + static_cast<size_t>(y + spread) * size.x + spread;
+            auto*       dst = outside.data() + static_cast<size_t>(y + spread) * size.x + spread;
+            for (uint32_t x = 0; x < bitmapSize.x; x++)
+            {
+                const bool isInside = src[x] >= 128;
+                in[x]               = isInside ? 0.0f : far_away;
+                dst[x]              = isInside ? far_away : 0.0f;
+            }
+        }
+
+        transform(inside, distInside, size, spread);
+        transform(outside, distOutside, size, spread);
+
+        // Combine into signed distance, positive inside. Pixel centers are half a pixel away from the edge.
+        const float scale = 0.5f / static_cast<float>(spread);
+        for (size_t i = 0; i < count; i++)
+        {
+            const float toInside  = std::max(std::sqrt(distInside[i]) - 0.5f, 0.0f);
+            const float toOutside = std::max(std::sqrt(distOutside[i]) - 0.5f, 0.0f);
+            const float value     = std::clamp(0.5f + (toOutside - toInside) * scale, 0.0f, 1.0f);
+            out[i]                = static_cast<uint8_t>(value * 255.0f + 0.5f);
+        }
+    }
+
+    void DistanceFieldGenerator::transform(const std::vector<float>& features,
+                                           std::vector<float>&       distances,
+                                           const math::uint2         size,
+                                           const uint32_t            spread)
+    {
+        const auto w = static_cast<int32_t>(size.x);
+        const auto h = static_cast<int32_t>(size.y);
+        const auto s = static_cast<int32_t>(spread);
+
+        // Vertical pass: for each pixel, squared distance to the nearest feature in the same column. Rows are combined
+        // as a whole, so the inner loop runs over contiguous memory.
+        column.assign(features.size(), far_away);
+        for (int32_t y = 0; y < h; y++)
+        {
+            auto* dst = column.data() + static_cast<size_t>(y) * w;
+            for (int32_t k = std::max(-s, -y); k <= std::min(s, h - 1 - y); k++)
+            {
+                const auto* src = features.data() + static_cast<size_t>(y + k) * w;
+                const auto  kk  = static_cast<float>(k * k);
+                for (int32_t x = 0; x < w; x++) dst[x] = std::min(dst[x], src[x] + kk);
+            }
+        }
+
+        // Horizontal pass: combine with columns within range.
+        distances.assign(features.size(), far_away);
+        for (int32_t y = 0; y < h; y++)
+        {
+            const auto* src = column.data() + static_cast<size_t>(y) * w;
+            auto*       dst = distances.data() + static_cast<size_t>(y) * w;
+            for (int32_t k = -s; k <= s; k++)
+            {
+                const auto kk    = static_cast<float>(k * k);
+                const auto first = std::max(0, -k);
+                const auto last  = std::min(w, w - k);
+                for (int32_t x = first; x < last; x++) dst[x] = std::min(dst[x], src[x + k] + kk);
+            }
+        }
+    }
+}  // namespace floah
@@ -0,0 +1,289 @@
+#include "floah-viz/font_cache.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-common/floah_error.h"
+
+namespace
+{
+    /**
+     * \brief Identifies a cache file.
+     */
+    constexpr char cache_magic[8] = {'F', 'L', 'O', 'A', 'H', 'F', 'N', 'T'};
+
+    /**
+     * \brief Increment whenever the file layout or the way FontMap generates its image changes.
+     */
+    constexpr uint32_t cache_version = 2;
+
+    /**
+     * \brief File header. Followed by characterCount records and width * height bytes of image data.
+     */
+    struct Header
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t characterCount;
+        uint64_t key;
+        uint32_t width;
+        uint32_t height;
+        int32_t  ascender;
+        int32_t  descender;
+        float    packingEfficiency;
+        uint32_t emSize;
+        /**
+         * \brief Hash of the records, chained with a hash of the image data.
+         */
+        uint64_t checksum;
+    };
+
+    /**
+     * \brief Character metrics as stored on disk.
+     */
+    struct Record
+    {
+        uint32_t code;
+        uint32_t size[2];
+        int32_t  bearing[2];
+        float    uv0[2];
+        float    uv1[2];
+        int32_t  advance;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header>);
+    static_assert(std::is_trivially_copyable_v<Record>);
+
+    constexpr uint64_t hash_seed = 0xcbf29ce484222325;
+
+    /**
+     * \brief Hash a block of bytes. Processes 8 bytes at a time, so that hashing large font files and images is
+     * cheap compared to regenerating them.
+     * \param bytes Bytes.
+     * \param seed Initial value, used to chain hashes.
+     * \return Hash.
+     */
+    [[nodiscard]] uint64_t hashBytes(const std::span<const uint8_t> bytes, uint64_t seed = hash_seed) noexcept
+    {
+        constexpr uint64_t prime = 0x9e3779b97f4a7c15;
+
+        uint64_t h = seed ^ (bytes.size() * prime);
+        size_t   i = 0;
+        for (; i + 8 <= bytes.size(); i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, bytes.data() + i, sizeof(word));
+            h = (h ^ word) * prime;
+            h ^= h >> 29;
+        }
+        for (; i < bytes.size(); i++) h = (h ^ bytes[i]) * 0x100000001b3;
+
+        return h;
+    }
+
+    template<typename T>
+    [[nodiscard]] std::span<const uint8_t> asBytes(const T& value) noexcept
+    {
+        return {reinterpret_cast<const uint8_t*>(&value), sizeof(T)};
+    }
+
+    [[nodiscard]] std::filesystem::path getEntryPath(const std::filesystem::path& directory, const uint64_t key)
+    {
+        return directory / std::format("{:016x}.fontcache", key);
+    }
+
+    /**
+     * \brief Get a temporary file suffix that is unique to this call. Processes are told apart by a random number,
+     * threads and calls within a process by the thread id and a counter.
+     * \return Suffix.
+     */
+    [[nodiscard]] std::string getTemporarySuffix()
+    {
+        static const uint64_t process = [] {
+            std::random_device device;
+            return static_cast<uint64_t>(device()) << 32 | device();
+        }();
+        static std::atomic<uint32_t> counter = 0;
+
+        const auto thread = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        return std::format(".{:016x}.{:x}.{}.tmp", process, thread, counter++);
+    }
+}  // namespace
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    FontCache::FontCache() = default;
+
+    FontCache::FontCache(std::filesystem::path cacheDirectory) : directory(std::move(cacheDirectory)) {}
+
+    FontCache::FontCache(const FontCache&) = default;
+
+    FontCache::FontCache(FontCache&&) noexcept = default;
+
+    FontCache::~FontCache() noexcept = default;
+
+    FontCache& FontCache::operator=(const FontCache&) = default;
+
+    FontCache& FontCache::operator=(FontCache&&) noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    const std::filesystem::path& FontCache::getDirectory() const noexcept { return directory; }
+
+    ////////////////////////////////////////////////////////////////
+    // Cache.
+    ////////////////////////////////////////////////////////////////
+
+    uint64_t FontCache::calculateKey(const std::filesystem::path& fontPath,
+                                     const math::uint2            fontSize,
+                                     const std::string&           characters,
+                                     const uint32_t               distanceFieldSpread)
+    {
+        const MappedFile file(fontPath);
+
+        auto key = hashBytes(file.getData());
+        key      = hashBytes(asBytes(fontSize.x), key);
+        key      = hashBytes(asBytes(fontSize.y), key);
+        key      = hashBytes(asBytes(distanceFieldSpread), key);
+        key      = hashBytes({reinterpret_cast<const uint8_t*>(characters.data()), characters.size()}, key);
+        return key;
+    }
+
+    std::optional<FontCache::Data> FontCache::load(const uint64_t key) const
+    {
+        const auto filePath = getEntryPath(directory, key);
+
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(filePath, ec)) return {};
+
+        Data data;
+        try
+        {
+            data.file = MappedFile(filePath);
+        }
+        catch (const FloahError&)
+        {
+            return {};
+        }
+
+        // Validate header.
+        const auto bytes = data.file.getData();
+        if (bytes.size() < sizeof(Header)) return {};
+        Header header;
+        std::memcpy(&header, bytes.data(), sizeof(Header));
+        if (std::memcmp(header.magic, cache_magic, sizeof(cache_magic)) != 0) return {};
+        if (header.version != cache_version || header.key != key) return {};
+
+        // Validate size and contents.
+        const auto recordsSize = static_cast<uint64_t>(header.characterCount) * sizeof(Record);
+        const auto pixelsSize  = static_cast<uint64_t>(header.width) * header.height;
+        if (bytes.size() != sizeof(Header) + recordsSize + pixelsSize) return {};
+        const auto records = bytes.subspan(sizeof(Header), recordsSize);
+        const auto pixels  = bytes.subspan(sizeof(Header) + recordsSize);
+        if (hashBytes(pixels, hashBytes(records)) != header.checksum) return {};
+
+        data.imageSize         = math::uint2(header.width, header.height);
+        data.ascender          = header.ascender;
+        data.descender         = header.descender;
+        data.emSize            = header.emSize;
+        data.packingEfficiency = header.packingEfficiency;
+
+        data.characters.reserve(header.characterCount);
+        for (uint32_t i = 0; i < header.characterCount; i++)
+        {
+            Record r;
+            std::memcpy(&r, records.data() + i * sizeof(Record), sizeof(Record));
+            data.characters.emplace_back(r.code,
+                                         FontMap::Character{.size    = math::uint2(r.size[0], r.size[1]),
+                                                            .bearing = math::int2(r.bearing[0], r.bearing[1]),
+                                                            .uv0     = math::float2(r.uv0[0], r.uv0[1]),
+                                                            .uv1     = math::float2(r.uv1[0], r.uv1[1]),
+                                                            .advance = r.advance});
+        }
+
+        data.pixels = pixels;
+        return data;
+    }
+
+    bool FontCache::store(const uint64_t key, const Data& data) const
+    {
+        std::vector<Record> records;
+        records.reserve(data.characters.size());
+        for (const auto& [code, c] : data.characters)
+            records.emplace_back(Record{.code    = code,
+                                        .size    = {c.size.x, c.size.y},
+                                        .bearing = {c.bearing.x, c.bearing.y},
+                                        .uv0     = {c.uv0.x, c.uv0.y},
+                                        .uv1     = {c.uv1.x, c.uv1.y},
+                                        .advance = c.advance});
+        const std::span recordBytes(reinterpret_cast<const uint8_t*>(records.data()), records.size() * sizeof(Record));
+
+        Header header{};
+        std::memcpy(header.magic, cache_magic, sizeof(cache_magic));
+        header.version           = cache_version;
+        header.characterCount    = static_cast<uint32_t>(records.size());
+        header.key               = key;
+        header.width             = data.imageSize.x;
+        header.height            = data.imageSize.y;
+        header.ascender          = data.ascender;
+        header.descender         = data.descender;
+        header.emSize            = data.emSize;
+        header.packingEfficiency = data.packingEfficiency;
+        header.checksum          = hashBytes(data.pixels, hashBytes(recordBytes));
+
+        // Write to a temporary file first, so that readers never see a partially written entry. Each writer uses its
+        // own file, so that concurrent stores of the same key cannot write into each other's data.
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        if (ec) return false;
+
+        const auto filePath = getEntryPath(directory, key);
+        auto       tmpPath  = filePath;
+        tmpPath += getTemporarySuffix();
+
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            const auto write = [&file](const std::span<const uint8_t> block) {
+                file.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(block.size()));
+            };
+            write(asBytes(header));
+            write(recordBytes);
+            write(data.pixels);
+            if (!file)
+            {
+                file.close();
+                std::filesystem::remove(tmpPath, ec);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(tmpPath, filePath, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+
+        return true;
+    }
+}  // namespace floah
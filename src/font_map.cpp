@@ -4,7 +4,14 @@
 // Standard includes.
 ////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <exception>
 #include <format>
+#include <limits>
+#include <list>
+#include <optional>
+#include <span>
+#include <thread>
 
 ////////////////////////////////////////////////////////////////
 // External includes.
@@ -13,6 +20,7 @@
 #include "freetype2/ft2build.h"
 #include FT_FREETYPE_H
 #include "unicode/unistr.h"
+#include "unicode/utf8.h"
 
 ////////////////////////////////////////////////////////////////
 // Module includes.
@@ -22,128 +30,426 @@
 #include "sol/texture/image2d.h"
 #include "sol/texture/texture_manager.h"
 
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/atlas_packer.h"
+#include "floah-viz/distance_field_generator.h"
+#include "floah-viz/font_cache.h"
+
 namespace
 {
     /**
-     * \brief Calculate the required image size to fit all characters. Tries to fill a square image, starting at
-     * 256x256, and repeatedly doubles size until all characters fit.
-     * \param face Face.
-     * \param chars List of characters.
-     * \return Image size (in pixels).
+     * \brief Marks an unused entry in the dense lookup table.
      */
-    [[nodiscard]] math::uint2 calculateImageSize(const FT_Face face, const icu::UnicodeString& chars)
+    constexpr uint32_t invalid_index = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * \brief Character codes below this value are stored in the dense lookup table.
+     */
+    constexpr uint32_t dense_limit = 0x10000;
+
+    /**
+     * \brief Largest image size glyphs will be packed into.
+     */
+    // TODO: Limit size by actual max texture size of device?
+    const math::uint2 max_image_size{16384, 16384};
+
+    /**
+     * \brief Number of empty pixels between glyphs.
+     */
+    constexpr uint32_t glyph_padding = 1;
+
+    /**
+     * \brief Minimum number of glyphs each thread should rasterize. Below this, starting a thread and loading the
+     * face is not worth it.
+     */
+    constexpr size_t min_glyphs_per_thread = 256;
+
+    /**
+     * \brief Get the format of the glyph image. Distance fields must be filtered by the sampler to render smoothly at
+     * any scale, which requires a normalized format. Coverage bitmaps keep the integer format.
+     * \param spread Distance field spread, or 0 for coverage bitmaps.
+     * \return Format.
+     */
+    [[nodiscard]] VkFormat getImageFormat(const uint32_t spread) noexcept
     {
-        std::vector<math::uint2> sizes;
-        for (int32_t i = 0; i < chars.countChar32(); i++)
+        return spread > 0 ? VK_FORMAT_R8_UNORM : VK_FORMAT_R8_UINT;
+    }
+
+    /**
+     * \brief Owns a FreeType library and face.
+     */
+    class FreeTypeFace
+    {
+    public:
+        FreeTypeFace(const std::filesystem::path& path, const math::uint2 size)
         {
-            // TODO: What to do if loading fails?
-            if (FT_Load_Char(face, chars.char32At(i), FT_LOAD_COMPUTE_METRICS)) continue;
+            // Load library.
+            auto err = FT_Init_FreeType(&library);
+            if (err) throw floah::FloahError(std::format("Failed to initialize FreeType Library. Error code: {}", err));
 
-            // Skip size 0 chars.
-            if (face->glyph->metrics.width == 0 || face->glyph->metrics.height == 0) continue;
+            // Load face.
+            err = FT_New_Face(library, path.string().c_str(), 0, &face);
+            if (err)
+            {
+                FT_Done_FreeType(library);
+                throw floah::FloahError(
+                  std::format("Failed to load font file {}. Error code: {}", path.string(), err));
+            }
 
-            sizes.emplace_back(face->glyph->metrics.width >> 6, face->glyph->metrics.height >> 6);
+            FT_Set_Pixel_Sizes(face, size.x, size.y);
         }
 
-        // Try to fit all characters into a square. Start with 256x256 and keep expanding until all chars fit.
-        math::uint2 imageSize{256, 256};
-        bool        fit = false;
-        while (!fit)
+        FreeTypeFace(const FreeTypeFace&) = delete;
+
+        FreeTypeFace(FreeTypeFace&&) = delete;
+
+        ~FreeTypeFace() noexcept
         {
-            fit = true;
+            FT_Done_Face(face);
+            FT_Done_FreeType(library);
+        }
 
-            uint32_t x = 0, y = 0, ymax = 0;
-            for (const auto& s : sizes)
-            {
-                // Glyph does not fit on current row anymore. Reset and move to next row.
-                if (x + s.x >= imageSize.x)
-                {
-                    x = 0;
-                    y += ymax;
-                    ymax = 0;
-                }
+        FreeTypeFace& operator=(const FreeTypeFace&) = delete;
+
+        FreeTypeFace& operator=(FreeTypeFace&&) = delete;
+
+        [[nodiscard]] FT_Face get() const noexcept { return face; }
+
+    private:
+        FT_Library library = nullptr;
 
-                // Glyph does not fit in image anymore.
-                if (y + s.y >= imageSize.y)
+        FT_Face face = nullptr;
+    };
+
+    /**
+     * \brief Rasterized glyph.
+     */
+    struct Glyph
+    {
+        /**
+         * \brief Character code.
+         */
+        UChar32 code;
+
+        /**
+         * \brief Bitmap size (in pixels).
+         */
+        math::uint2 size;
+
+        /**
+         * \brief Bitmap bearing (in pixels).
+         */
+        math::int2 bearing;
+
+        /**
+         * \brief Horizontal advance (in 1/64th pixels).
+         */
+        int32_t advance;
+
+        /**
+         * \brief Offset of the tightly packed bitmap in the arena.
+         */
+        size_t offset;
+    };
+
+    /**
+     * \brief CPU-side storage for rasterized glyphs.
+     */
+    struct GlyphArena
+    {
+        /**
+         * \brief List of glyphs.
+         */
+        std::vector<Glyph> glyphs;
+
+        /**
+         * \brief Bitmaps of all glyphs.
+         */
+        std::vector<uint8_t> pixels;
+
+        /**
+         * \brief Used to convert bitmaps to distance fields.
+         */
+        floah::DistanceFieldGenerator distanceField;
+    };
+
+    /**
+     * \brief Decode a UTF-8 string into a list of character codes.
+     * \param chars UTF-8 string.
+     * \return List of character codes.
+     */
+    [[nodiscard]] std::vector<UChar32> decodeCharacters(const std::string& chars)
+    {
+        std::vector<UChar32> codes;
+        codes.reserve(chars.size());
+
+        const auto*   str    = reinterpret_cast<const uint8_t*>(chars.data());
+        const int32_t length = static_cast<int32_t>(chars.size());
+        for (int32_t i = 0; i < length;)
+        {
+            UChar32 c;
+            U8_NEXT(str, i, length, c);
+            if (c >= 0) codes.emplace_back(c);
+        }
+
+        return codes;
+    }
+
+    /**
+     * \brief Render all characters and append their bitmaps to the arena. Each glyph is loaded only once.
+     * \param face Face.
+     * \param codes List of character codes.
+     * \param spread If not 0, bitmaps are converted to distance fields with this range (in pixels).
+     * \param arena Arena.
+     */
+    void rasterizeGlyphs(const FT_Face                  face,
+                         const std::span<const UChar32> codes,
+                         const uint32_t                 spread,
+                         GlyphArena&                    arena)
+    {
+        arena.glyphs.reserve(arena.glyphs.size() + codes.size());
+
+        for (const auto code : codes)
+        {
+            // TODO: What to do if loading fails?
+            if (FT_Load_Char(face, static_cast<FT_ULong>(code), FT_LOAD_RENDER)) continue;
+
+            const auto& glyph  = *face->glyph;
+            const auto& bitmap = glyph.bitmap;
+            const auto  offset = arena.pixels.size();
+
+            // Empty glyphs need no distance field.
+            if (spread == 0 || bitmap.width == 0 || bitmap.rows == 0)
+            {
+                arena.glyphs.emplace_back(Glyph{.code    = code,
+                                                .size    = math::uint2(bitmap.width, bitmap.rows),
+                                                .bearing = math::int2(glyph.bitmap_left, glyph.bitmap_top),
+                                                .advance = static_cast<int32_t>(glyph.advance.x),
+                                                .offset  = offset});
+
+                // Copy bitmap row by row, as rows in the FreeType bitmap can be padded.
+                for (uint32_t row = 0; row < bitmap.rows; row++)
                 {
-                    // TODO: Limit size by max texture size?
-                    imageSize *= static_cast<uint32_t>(2);
-                    fit = false;
-                    break;
+                    const auto* src = bitmap.buffer + static_cast<ptrdiff_t>(row) * bitmap.pitch;
+                    arena.pixels.insert(arena.pixels.end(), src, src + bitmap.width);
                 }
 
-                x += s.x;
-                ymax = std::max(ymax, s.y);
+                continue;
             }
-        }
 
-        return imageSize;
+            // Distance field extends spread pixels beyond the bitmap on each side.
+            const auto s    = static_cast<int32_t>(spread);
+            const auto size = math::uint2(bitmap.width + 2 * spread, bitmap.rows + 2 * spread);
+            arena.glyphs.emplace_back(Glyph{.code    = code,
+                                            .size    = size,
+                                            .bearing = math::int2(glyph.bitmap_left - s, glyph.bitmap_top + s),
+                                            .advance = static_cast<int32_t>(glyph.advance.x),
+                                            .offset  = offset});
+            arena.pixels.resize(offset + static_cast<size_t>(size.x) * size.y);
+            arena.distanceField.generate(bitmap.buffer,
+                                         math::uint2(bitmap.width, bitmap.rows),
+                                         static_cast<size_t>(bitmap.pitch),
+                                         spread,
+                                         std::span(arena.pixels).subspan(offset));
+        }
     }
 
     /**
-     * \brief Fill an image with all rendered characters and store in character map.
-     * \param face Face.
-     * \param chars List of characters.
-     * \param image Image to fill.
-     * \param characterMap Character map to store metrics in.
+     * \brief Render all characters on multiple threads. Each thread loads its own face and renders a contiguous chunk
+     * of characters. Chunks are appended in order, so the result is identical to rendering on a single thread.
+     * \param path Path to font file.
+     * \param size Font size.
+     * \param codes List of character codes.
+     * \param spread Distance field range, or 0.
+     * \param threadCount Number of threads.
+     * \return Arena.
      */
-    void fillImage(const FT_Face                                            face,
-                   const icu::UnicodeString&                                chars,
-                   sol::Image2D&                                            image,
-                   std::unordered_map<uint32_t, floah::FontMap::Character>& characterMap)
+    [[nodiscard]] GlyphArena rasterizeGlyphsParallel(const std::filesystem::path&   path,
+                                                     const math::uint2              size,
+                                                     const std::span<const UChar32> codes,
+                                                     const uint32_t                 spread,
+                                                     const size_t                   threadCount)
     {
-        image.createStagingBuffer();
+        std::vector<GlyphArena>         arenas(threadCount);
+        std::vector<std::exception_ptr> errors(threadCount);
 
-        uint32_t x = 0, y = 0, ymax = 0;
-        for (int32_t i = 0; i < chars.countChar32(); i++)
         {
-            const auto uchar = chars.char32At(i);
-            // TODO: What if loading fails?
-            if (FT_Load_Char(face, uchar, FT_LOAD_RENDER)) continue;
+            std::vector<std::jthread> threads;
+            threads.reserve(threadCount);
+            const auto chunkSize = (codes.size() + threadCount - 1) / threadCount;
+            for (size_t i = 0; i < threadCount; i++)
+            {
+                const auto first = std::min(i * chunkSize, codes.size());
+                const auto chunk = codes.subspan(first, std::min(chunkSize, codes.size() - first));
+                threads.emplace_back([&path, size, chunk, spread, &arena = arenas[i], &error = errors[i]] {
+                    try
+                    {
+                        const FreeTypeFace face(path, size);
+                        rasterizeGlyphs(face.get(), chunk, spread, arena);
+                    }
+                    catch (...)
+                    {
+                        error = std::current_exception();
+                    }
+                });
+            }
+        }
 
-            // Glyph does not fit on current row anymore. Reset and move to next row.
-            if (x + face->glyph->bitmap.width >= image.getWidth())
+        for (const auto& error : errors)
+            if (error) std::rethrow_exception(error);
+
+        // Merge all chunks into the first arena.
+        auto& arena = arenas.front();
+        for (size_t i = 1; i < threadCount; i++)
+        {
+            const auto offset = arena.pixels.size();
+            for (auto& glyph : arenas[i].glyphs)
             {
-                x = 0;
-                y += ymax;
-                ymax = 0;
+                glyph.offset += offset;
+                arena.glyphs.emplace_back(glyph);
             }
+            arena.pixels.insert(arena.pixels.end(), arenas[i].pixels.begin(), arenas[i].pixels.end());
+        }
+
+        return std::move(arena);
+    }
+
+    /**
+     * \brief Pack all glyphs into the smallest image that fits them.
+     * \param arena Arena.
+     * \return Packing result.
+     */
+    [[nodiscard]] floah::AtlasPacker::Result packGlyphs(const GlyphArena& arena)
+    {
+        std::vector<math::uint2> sizes;
+        sizes.reserve(arena.glyphs.size());
+        for (const auto& glyph : arena.glyphs) sizes.emplace_back(glyph.size);
+
+        return floah::AtlasPacker::pack(sizes, glyph_padding, max_image_size);
+    }
+
+    /**
+     * \brief Compose all glyph bitmaps into a single image-sized bitmap and calculate character metrics.
+     * \param arena Arena.
+     * \param packing Packing result.
+     * \param pixels Bitmap to fill. Must be zero-initialized and sized to the image.
+     * \return List of character metrics.
+     */
+    [[nodiscard]] std::vector<std::pair<uint32_t, floah::FontMap::Character>>
+      blitGlyphs(const GlyphArena& arena, const floah::AtlasPacker::Result& packing, std::vector<uint8_t>& pixels)
+    {
+        std::vector<std::pair<uint32_t, floah::FontMap::Character>> characters;
+        characters.reserve(arena.glyphs.size());
+
+        const auto imageSize = math::float2(packing.imageSize);
+        for (size_t i = 0; i < arena.glyphs.size(); i++)
+        {
+            const auto& glyph = arena.glyphs[i];
+            const auto  pos   = packing.positions[i];
 
             // Copy bitmap.
-            if (face->glyph->bitmap.width != 0 && face->glyph->bitmap.rows != 0)
-                image.setData(
-                  face->glyph->bitmap.buffer, {x, y}, {face->glyph->bitmap.width, face->glyph->bitmap.rows}, 0);
+            for (uint32_t row = 0; row < glyph.size.y; row++)
+            {
+                const auto* src = arena.pixels.data() + glyph.offset + static_cast<size_t>(row) * glyph.size.x;
+                auto* dst = pixels.data() + static_cast<size_t>(pos.y + row) * packing.imageSize.x + pos.x;
+                std::copy_n(src, glyph.size.x, dst);
+            }
 
             // Store character.
-            const auto size    = math::uint2(face->glyph->bitmap.width, face->glyph->bitmap.rows);
-            const auto bearing = math::int2(face->glyph->bitmap_left, face->glyph->bitmap_top);
-            const auto uv0     = math::float2(static_cast<float>(x) / static_cast<float>(image.getWidth()),
-                                          static_cast<float>(y) / static_cast<float>(image.getHeight()));
-            const auto uv1     = uv0 + math::float2(static_cast<float>(size.x) / static_cast<float>(image.getWidth()),
-                                                static_cast<float>(size.y) / static_cast<float>(image.getHeight()));
-            const auto advance = face->glyph->advance.x;
-            characterMap.try_emplace(
-              static_cast<uint32_t>(uchar),
-              floah::FontMap::Character{.size = size, .bearing = bearing, .uv0 = uv0, .uv1 = uv1, .advance = advance});
-
-            // Move right.
-            x += face->glyph->bitmap.width;
-            // Keep track of highest glyph in current row.
-            ymax = std::max(ymax, face->glyph->bitmap.rows);
+            const auto uv0 = math::float2(pos) / imageSize;
+            const auto uv1 = math::float2(pos + glyph.size) / imageSize;
+            characters.emplace_back(static_cast<uint32_t>(glyph.code),
+                                    floah::FontMap::Character{.size    = glyph.size,
+                                                              .bearing = glyph.bearing,
+                                                              .uv0     = uv0,
+                                                              .uv1     = uv1,
+                                                              .advance = glyph.advance});
         }
+
+        return characters;
     }
 }  // namespace
 
 namespace floah
 {
+    ////////////////////////////////////////////////////////////////
+    // Types.
+    ////////////////////////////////////////////////////////////////
+
+    struct FontMap::DynamicState
+    {
+        DynamicState(const std::filesystem::path& path, const math::uint2 size) : face(path, size) {}
+
+        /**
+         * \brief Face that stays loaded to rasterize characters on demand.
+         */
+        FreeTypeFace face;
+
+        /**
+         * \brief Size of each cell, including padding (in pixels).
+         */
+        math::uint2 cellSize;
+
+        /**
+         * \brief Number of cells in each row of the image.
+         */
+        uint32_t cellsPerRow = 0;
+
+        /**
+         * \brief Number of cells that have been used at least once. Cells are handed out in order.
+         */
+        uint32_t usedCells = 0;
+
+        /**
+         * \brief Character code stored in each cell.
+         */
+        std::vector<uint32_t> cellCodes;
+
+        /**
+         * \brief Used cells, from most to least recently used.
+         */
+        std::list<uint32_t> lru;
+
+        /**
+         * \brief Position of each used cell in the lru list.
+         */
+        std::vector<std::list<uint32_t>::iterator> lruPositions;
+
+        /**
+         * \brief Scratch storage for rasterizing a single glyph.
+         */
+        GlyphArena arena;
+
+        /**
+         * \brief Scratch storage for the pixels of a single cell.
+         */
+        std::vector<uint8_t> cellPixels;
+    };
+
+    struct FontMap::ImageData
+    {
+        /**
+         * \brief Generated or cached image and metrics. The pixels point into the pixels list or the cache file.
+         */
+        FontCache::Data data;
+
+        /**
+         * \brief Pixels of a newly generated image.
+         */
+        std::vector<uint8_t> pixels;
+    };
+
     ////////////////////////////////////////////////////////////////
     // Constructors.
     ////////////////////////////////////////////////////////////////
 
     FontMap::FontMap() = default;
 
-    FontMap::FontMap(std::filesystem::path fontPath, const char* characters, math::uint2 fontSize) :
-        path(std::move(fontPath)), chars(characters), size(std::move(fontSize))
+    FontMap::FontMap(std::filesystem::path fontPath, const char* characterList, math::uint2 fontSize) :
+        path(std::move(fontPath)), chars(characterList), size(std::move(fontSize))
     {
     }
 
@@ -180,53 +486,359 @@ namespace floah
 
     int32_t FontMap::getFontDescender() const noexcept { return descender; }
 
+    float FontMap::getPackingEfficiency() const noexcept { return packingEfficiency; }
+
+    uint32_t FontMap::getThreadCount() const noexcept { return threadCount; }
+
+    const std::filesystem::path& FontMap::getCacheDirectory() const noexcept { return cacheDirectory; }
+
+    uint32_t FontMap::getEmSize() const noexcept { return emSize; }
+
+    uint32_t FontMap::getDistanceFieldSpread() const noexcept { return distanceFieldSpread; }
+
+    bool FontMap::isDynamic() const noexcept { return dynamicImageSize.x != 0 && dynamicImageSize.y != 0; }
+
+    uint64_t FontMap::getGeneration() const noexcept { return generation; }
+
+    const std::vector<FontMap::Region>& FontMap::getDirtyRegions() const noexcept { return dirtyRegions; }
+
     sol::Image2D* FontMap::getImage() const noexcept { return image; }
 
     sol::Texture2D* FontMap::getTexture() const noexcept { return texture; }
 
     const FontMap::Character& FontMap::getCharacter(const uint32_t c) const
     {
-        const auto it = characterMap.find(c);
+        const auto* character = findCharacter(c);
         // TODO: Return 'missing' character?
-        if (it == characterMap.end()) throw FloahError(std::format("Unknown character {}.", c));
+        if (!character) throw FloahError(std::format("Unknown character {}.", c));
 
-        return it->second;
+        return *character;
     }
 
+    ////////////////////////////////////////////////////////////////
+    // Character lookup.
+    ////////////////////////////////////////////////////////////////
+
+    const FontMap::Character* FontMap::findCharacter(const uint32_t c) const noexcept
+    {
+        // Fast path: direct lookup.
+        if (c < denseIndex.size())
+        {
+            const auto index = denseIndex[c];
+            return index == invalid_index ? nullptr : &characters[index];
+        }
+
+        if (c < dense_limit) return nullptr;
+
+        // Slow path: binary search through sorted codes.
+        const auto it = std::ranges::lower_bound(sparseIndex, c, {}, &std::pair<uint32_t, uint32_t>::first);
+        if (it == sparseIndex.end() || it->first != c) return nullptr;
+        return &characters[it->second];
+    }
+
+    void FontMap::setCharacters(std::vector<std::pair<uint32_t, Character>> list)
+    {
+        characters.clear();
+        denseIndex.clear();
+        sparseIndex.clear();
+        characters.reserve(list.size());
+
+        // Size dense table to the highest code that goes in it.
+        uint32_t denseSize = 0;
+        for (const auto& [c, _] : list)
+            if (c < dense_limit) denseSize = std::max(denseSize, c + 1);
+        denseIndex.resize(denseSize, invalid_index);
+
+        for (auto& [c, character] : list)
+        {
+            if (c < dense_limit)
+            {
+                if (denseIndex[c] != invalid_index) continue;
+                denseIndex[c] = static_cast<uint32_t>(characters.size());
+            }
+            else
+                sparseIndex.emplace_back(c, static_cast<uint32_t>(characters.size()));
+
+            characters.emplace_back(std::move(character));
+        }
+
+        // Sort sparse codes and drop duplicates, keeping the first occurrence.
+        std::ranges::stable_sort(sparseIndex, {}, &std::pair<uint32_t, uint32_t>::first);
+        const auto dupes = std::ranges::unique(sparseIndex, {}, &std::pair<uint32_t, uint32_t>::first);
+        sparseIndex.erase(dupes.begin(), dupes.end());
+    }
+
+    void FontMap::insertCharacter(const uint32_t c, const uint32_t index)
+    {
+        if (c < dense_limit)
+        {
+            if (c >= denseIndex.size()) denseIndex.resize(c + 1, invalid_index);
+            denseIndex[c] = index;
+            return;
+        }
+
+        const auto it = std::ranges::lower_bound(sparseIndex, c, {}, &std::pair<uint32_t, uint32_t>::first);
+        if (it != sparseIndex.end() && it->first == c)
+            it->second = index;
+        else
+            sparseIndex.emplace(it, c, index);
+    }
+
+    void FontMap::eraseCharacter(const uint32_t c) noexcept
+    {
+        if (c < dense_limit)
+        {
+            if (c < denseIndex.size()) denseIndex[c] = invalid_index;
+            return;
+        }
+
+        const auto it = std::ranges::lower_bound(sparseIndex, c, {}, &std::pair<uint32_t, uint32_t>::first);
+        if (it != sparseIndex.end() && it->first == c) sparseIndex.erase(it);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Setters.
+    ////////////////////////////////////////////////////////////////
+
+    void FontMap::setThreadCount(const uint32_t count) noexcept { threadCount = count; }
+
+    void FontMap::setCacheDirectory(std::filesystem::path directory) { cacheDirectory = std::move(directory); }
+
+    void FontMap::setDynamic(const math::uint2 imageSize) { dynamicImageSize = imageSize; }
+
+    void FontMap::setDistanceField(const uint32_t spread) noexcept { distanceFieldSpread = spread; }
+
+    void FontMap::clearDirtyRegions() noexcept { dirtyRegions.clear(); }
+
     ////////////////////////////////////////////////////////////////
     // Generate.
     ////////////////////////////////////////////////////////////////
 
+    void FontMap::generateImageData()
+    {
+        // Image data was already generated, or is generated on demand.
+        if (imageData || image || isDynamic()) return;
+
+        auto result = std::make_unique<ImageData>();
+
+        // Try to load from cache first.
+        std::optional<FontCache> cache;
+        uint64_t                 cacheKey = 0;
+        bool                     cached   = false;
+        if (!cacheDirectory.empty())
+        {
+            cache.emplace(cacheDirectory);
+            cacheKey = FontCache::calculateKey(path, size, chars, distanceFieldSpread);
+            if (auto data = cache->load(cacheKey))
+            {
+                result->data = std::move(*data);
+                cached       = true;
+            }
+        }
+
+        // Generate from scratch.
+        if (!cached)
+        {
+            auto&      data  = result->data;
+            const auto codes = decodeCharacters(chars);
+
+            // Use as many threads as requested, while still giving each thread a decent amount of work.
+            size_t threads = threadCount ? threadCount : std::max(std::thread::hardware_concurrency(), 1u);
+            threads        = std::clamp<size_t>(codes.size() / min_glyphs_per_thread, 1, threads);
+
+            // Render all glyphs once.
+            GlyphArena arena;
+            {
+                const FreeTypeFace face(path, size);
+                data.ascender  = face.get()->ascender >> 6;
+                data.descender = face.get()->descender >> 6;
+
+                data.emSize    = face.get()->size->metrics.y_ppem;
+
+                if (threads == 1) rasterizeGlyphs(face.get(), codes, distanceFieldSpread, arena);
+            }
+            if (threads > 1) arena = rasterizeGlyphsParallel(path, size, codes, distanceFieldSpread, threads);
+
+            // Pack glyphs and compose the image on the CPU.
+            const auto packing = packGlyphs(arena);
+            result->pixels.resize(static_cast<size_t>(packing.imageSize.x) * packing.imageSize.y, 0);
+            data.characters        = blitGlyphs(arena, packing, result->pixels);
+            data.imageSize         = packing.imageSize;
+            data.packingEfficiency = packing.efficiency;
+            data.pixels            = result->pixels;
+
+            if (cache) cache->store(cacheKey, data);
+        }
+
+        ascender          = result->data.ascender;
+        descender         = result->data.descender;
+        emSize            = result->data.emSize;
+        packingEfficiency = result->data.packingEfficiency;
+        setCharacters(std::move(result->data.characters));
+        imageData = std::move(result);
+    }
+
     void FontMap::generateTexture(sol::TextureManager& textureManager)
     {
         // Texture was already generated.
         if (image) return;
 
-        const icu::UnicodeString ustr = icu::UnicodeString::fromUTF8(chars);
+        if (isDynamic())
+        {
+            generateDynamicTexture(textureManager);
+            return;
+        }
 
-        // Load library.
-        FT_Library ft;
-        auto       err = FT_Init_FreeType(&ft);
-        if (err) throw FloahError(std::format("Failed to initialize FreeType Library. Error code: {}", err));
+        generateImageData();
 
-        // Load face.
-        FT_Face face;
-        err = FT_New_Face(ft, path.string().c_str(), 0, &face);
-        if (err) throw FloahError(std::format("Failed to load font file {}. Error code: {}", path.string(), err));
+        // Create image and texture object.
+        const auto& data = imageData->data;
+        image            = &textureManager.createImage2D(getImageFormat(distanceFieldSpread),
+                                                         {data.imageSize.x, data.imageSize.y});
+        texture          = &textureManager.createTexture2D(*image);
+        image->createStagingBuffer();
+        image->setData(data.pixels.data(), {0, 0}, {data.imageSize.x, data.imageSize.y}, 0);
+
+        // The staging buffer holds a copy of the pixels.
+        imageData.reset();
+    }
 
-        FT_Set_Pixel_Sizes(face, size.x, size.y);
-        ascender  = face->ascender >> 6;
-        descender = face->descender >> 6;
+    const FontMap::Character& FontMap::acquireCharacter(const uint32_t c)
+    {
+        if (const auto* character = findCharacter(c))
+        {
+            // Move to front of lru list.
+            if (dynamic)
+            {
+                const auto cell = static_cast<size_t>(character - characters.data());
+                dynamic->lru.splice(dynamic->lru.begin(), dynamic->lru, dynamic->lruPositions[cell]);
+            }
 
-        // Create image and texture object.
-        const auto imageSize = calculateImageSize(face, ustr);
-        image                = &textureManager.createImage2D(VK_FORMAT_R8_UINT, {imageSize.x, imageSize.y});
-        texture              = &textureManager.createTexture2D(*image);
+            return *character;
+        }
+
+        if (!dynamic) throw FloahError(std::format("Unknown character {}.", c));
+
+        const auto* character = loadCharacter(c);
+        if (!character) throw FloahError(std::format("Failed to load character {}.", c));
+        return *character;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Dynamic.
+    ////////////////////////////////////////////////////////////////
+
+    void FontMap::generateDynamicTexture(sol::TextureManager& textureManager)
+    {
+        dynamic         = std::make_unique<DynamicState>(path, size);
+        const auto face = dynamic->face.get();
+        ascender        = face->ascender >> 6;
+        descender       = face->descender >> 6;
+        emSize          = face->size->metrics.y_ppem;
+
+        // Make cells large enough for the largest glyph in the face.
+        const auto& metrics = face->size->metrics;
+        math::uint2 cellSize(static_cast<uint32_t>((metrics.max_advance + 63) >> 6),
+                             static_cast<uint32_t>((metrics.ascender - metrics.descender + 63) >> 6));
+        if (FT_IS_SCALABLE(face))
+        {
+            const auto bboxWidth  = FT_MulFix(face->bbox.xMax - face->bbox.xMin, metrics.x_scale);
+            const auto bboxHeight = FT_MulFix(face->bbox.yMax - face->bbox.yMin, metrics.y_scale);
+            cellSize.x            = std::max(cellSize.x, static_cast<uint32_t>((bboxWidth + 63) >> 6));
+            cellSize.y            = std::max(cellSize.y, static_cast<uint32_t>((bboxHeight + 63) >> 6));
+        }
+        cellSize.x += glyph_padding + 2 * distanceFieldSpread;
+        cellSize.y += glyph_padding + 2 * distanceFieldSpread;
+
+        const auto cellsPerRow = dynamicImageSize.x / cellSize.x;
+        const auto cellCount   = cellsPerRow * (dynamicImageSize.y / cellSize.y);
+        if (cellCount == 0)
+            throw FloahError(std::format("Dynamic FontMap image of {}x{} pixels cannot fit a glyph of {}x{} pixels.",
+                                         dynamicImageSize.x,
+                                         dynamicImageSize.y,
+                                         cellSize.x,
+                                         cellSize.y));
+
+        dynamic->cellSize    = cellSize;
+        dynamic->cellsPerRow = cellsPerRow;
+        dynamic->cellCodes.resize(cellCount, invalid_index);
+        dynamic->lruPositions.resize(cellCount);
+        characters.assign(cellCount, Character{});
+        denseIndex.clear();
+        sparseIndex.clear();
+
+        // Create empty image and texture object.
+        image   = &textureManager.createImage2D(getImageFormat(distanceFieldSpread),
+                                                {dynamicImageSize.x, dynamicImageSize.y});
+        texture = &textureManager.createTexture2D(*image);
+        image->createStagingBuffer();
+        const std::vector<uint8_t> pixels(static_cast<size_t>(dynamicImageSize.x) * dynamicImageSize.y, 0);
+        image->setData(pixels.data(), {0, 0}, {dynamicImageSize.x, dynamicImageSize.y}, 0);
+
+        // Preload character list.
+        for (const auto code : decodeCharacters(chars))
+        {
+            const auto c = static_cast<uint32_t>(code);
+            if (!findCharacter(c)) static_cast<void>(loadCharacter(c));
+        }
+
+        // Whole image is uploaded anyway.
+        dirtyRegions.clear();
+    }
 
-        // Fill image.
-        fillImage(face, ustr, *image, characterMap);
+    const FontMap::Character* FontMap::loadCharacter(const uint32_t c)
+    {
+        auto& d = *dynamic;
+
+        // Rasterize.
+        d.arena.glyphs.clear();
+        d.arena.pixels.clear();
+        const auto code = static_cast<UChar32>(c);
+        rasterizeGlyphs(d.face.get(), {&code, 1}, distanceFieldSpread, d.arena);
+        if (d.arena.glyphs.empty()) return nullptr;
+        const auto& glyph = d.arena.glyphs.front();
+
+        // Take the next unused cell, or evict the least recently used one.
+        uint32_t cell;
+        if (d.usedCells < d.cellCodes.size())
+        {
+            cell = d.usedCells++;
+            d.lru.push_front(cell);
+            d.lruPositions[cell] = d.lru.begin();
+        }
+        else
+        {
+            cell = d.lru.back();
+            d.lru.splice(d.lru.begin(), d.lru, d.lruPositions[cell]);
+            eraseCharacter(d.cellCodes[cell]);
+            generation++;
+        }
 
-        FT_Done_Face(face);
-        FT_Done_FreeType(ft);
+        // Compose cell, cropping glyphs that are larger than the face claims they can be.
+        const auto offset    = math::uint2((cell % d.cellsPerRow) * d.cellSize.x,
+                                           (cell / d.cellsPerRow) * d.cellSize.y);
+        const auto glyphSize = math::uint2(std::min(glyph.size.x, d.cellSize.x - glyph_padding),
+                                           std::min(glyph.size.y, d.cellSize.y - glyph_padding));
+        d.cellPixels.assign(static_cast<size_t>(d.cellSize.x) * d.cellSize.y, 0);
+        for (uint32_t row = 0; row < glyphSize.y; row++)
+            std::copy_n(d.arena.pixels.data() + static_cast<size_t>(row) * glyph.size.x,
+                        glyphSize.x,
+                        d.cellPixels.data() + static_cast<size_t>(row) * d.cellSize.x);
+
+        // Write cell to image.
+        image->setData(d.cellPixels.data(), {offset.x, offset.y}, {d.cellSize.x, d.cellSize.y}, 0);
+        dirtyRegions.emplace_back(Region{.offset = offset, .size = d.cellSize});
+
+        // Store character.
+        const auto imageSize = math::float2(dynamicImageSize);
+        characters[cell]     = Character{.size    = glyphSize,
+                                         .bearing = glyph.bearing,
+                                         .uv0     = math::float2(offset) / imageSize,
+                                         .uv1     = math::float2(offset + glyphSize) / imageSize,
+                                         .advance = glyph.advance};
+        d.cellCodes[cell]    = c;
+        insertCharacter(c, cell);
+
+        return &characters[cell];
     }
 }  // namespace floah
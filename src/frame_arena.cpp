@@ -0,0 +1,97 @@
+#include "floah-viz/frame_arena.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+namespace
+{
+    constexpr size_t default_capacity = 64 * 1024;
+
+    [[nodiscard]] size_t alignUp(const size_t value, const size_t alignment) noexcept
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}  // namespace
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    FrameArena::FrameArena() : FrameArena(default_capacity) {}
+
+    FrameArena::FrameArena(const size_t initialCapacity)
+    {
+        const auto size = std::max<size_t>(initialCapacity, 1);
+        blocks.emplace_back(std::make_unique_for_overwrite<std::byte[]>(size), size);
+    }
+
+    FrameArena::~FrameArena() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    size_t FrameArena::getUsed() const noexcept { return previousUsed + offset; }
+
+    size_t FrameArena::getCapacity() const noexcept
+    {
+        return std::accumulate(
+          blocks.begin(), blocks.end(), size_t{0}, [](const size_t sum, const Block& b) { return sum + b.size; });
+    }
+
+    size_t FrameArena::getHighWaterMark() const noexcept { return highWaterMark; }
+
+    ////////////////////////////////////////////////////////////////
+    // Reset.
+    ////////////////////////////////////////////////////////////////
+
+    void FrameArena::reset()
+    {
+        // Merge overflow blocks into one, so that the next frame with the same usage fits without allocating.
+        if (blocks.size() > 1)
+        {
+            const auto size = getCapacity();
+            blocks.clear();
+            blocks.emplace_back(std::make_unique_for_overwrite<std::byte[]>(size), size);
+        }
+
+        offset       = 0;
+        previousUsed = 0;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Memory resource.
+    ////////////////////////////////////////////////////////////////
+
+    void* FrameArena::do_allocate(const size_t bytes, const size_t alignment)
+    {
+        auto* block   = &blocks.back();
+        auto  address = reinterpret_cast<uintptr_t>(block->data.get());
+        auto  start   = alignUp(address + offset, alignment) - address;
+
+        // Start a new block that is at least twice as large as the last one.
+        if (start + bytes > block->size)
+        {
+            const auto size = std::max(block->size * 2, bytes + alignment);
+            previousUsed += offset;
+            block   = &blocks.emplace_back(std::make_unique_for_overwrite<std::byte[]>(size), size);
+            address = reinterpret_cast<uintptr_t>(block->data.get());
+            start   = alignUp(address, alignment) - address;
+        }
+
+        offset        = start + bytes;
+        highWaterMark = std::max(highWaterMark, getUsed());
+        return block->data.get() + start;
+    }
+
+    void FrameArena::do_deallocate(void*, size_t, size_t) {}
+
+    bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept { return this == &other; }
+}  // namespace floah
@@ -1,10 +1,20 @@
 #include "floah-viz/generators/circle_generator.h"
 
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
 
 #include "common/enum_classes.h"
+#include "floah-common/floah_error.h"
 #include "sol/mesh/indexed_mesh.h"
 #include "sol/mesh/mesh_description.h"
 #include "sol/mesh/mesh_manager.h"
@@ -13,8 +23,59 @@
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "floah-viz/index_data.h"
 #include "floah-viz/vertex.h"
 
+namespace
+{
+    /**
+     * \brief Bounds of the automatic segment count. Both are multiples of segment_step.
+     */
+    constexpr uint32_t min_segments = 8;
+    constexpr uint32_t max_segments = 1024;
+
+    /**
+     * \brief Automatic segment counts are rounded up to a multiple of this, so that only a small number of distinct
+     * unit circle tables is ever computed.
+     */
+    constexpr uint32_t segment_step = 8;
+
+    /**
+     * \brief Compute the points on the unit circle for a segment count.
+     * \param table Output list. Replaced with count points.
+     * \param count Segment count.
+     */
+    void computeUnitCircle(std::vector<math::float2>& table, const uint32_t count)
+    {
+        table.clear();
+        table.reserve(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const float a = static_cast<float>(i) / static_cast<float>(count) * math::m_pi * 2;
+            table.emplace_back(math::cos(a), math::sin(a));
+        }
+    }
+
+    /**
+     * \brief Get the points on the unit circle for a segment count of at most max_segments. Tables are computed once
+     * and shared by all generators, so there are never more than max_segments of them.
+     * \param count Segment count.
+     * \return List of count points.
+     */
+    const std::vector<math::float2>& getSharedUnitCircle(const uint32_t count)
+    {
+        static std::mutex                                              mutex;
+        static std::unordered_map<uint32_t, std::vector<math::float2>> tables;
+
+        std::scoped_lock lock(mutex);
+        auto [it, inserted] = tables.try_emplace(count);
+        if (inserted) computeUnitCircle(it->second, count);
+
+        // Elements of an unordered_map are never moved, so the reference remains valid after unlocking.
+        return it->second;
+    }
+}  // namespace
+
 namespace floah
 {
     ////////////////////////////////////////////////////////////////
@@ -26,95 +87,57 @@ namespace floah
     CircleGenerator::~CircleGenerator() noexcept = default;
 
     ////////////////////////////////////////////////////////////////
-    // Generate.
+    // Getters.
     ////////////////////////////////////////////////////////////////
 
-    sol::IMesh& CircleGenerator::generate(Params& params)
+    uint32_t CircleGenerator::getSegmentCount() const
     {
-        if (params.mesh) throw std::runtime_error("Update not yet implemented");
-
-        // Circle will consist of an outer rim of quads and an inner triangle fan.
-        std::vector<Vertex>   vertices(vertexCount * 3 + 1);
-        std::vector<uint32_t> indices(vertexCount * 3 * 3, 0);
-
-        const auto innerRadius = radius - static_cast<float>(margin.get(static_cast<int32_t>(radius)));
-        const auto rel         = innerRadius / radius;
-
-        for (uint32_t i = 0; i < vertexCount; i++)
-        {
-            const float a       = static_cast<float>(i) / static_cast<float>(vertexCount) * math::m_pi * 2;
-            const float x       = math::cos(a);
-            const float y       = math::sin(a);
-            const auto  uv      = math::float2(x, y) * 0.5f + 0.5f;
-            const auto  uvInner = uv * rel;
-
-            // Outside of rim.
-            vertices[i].position = math::float4(center.x, center.y) + math::float4(x, y, 0, 0) * radius;
-            vertices[i].color    = math::float4(1, 1, 1, 1);
-            vertices[i].uv       = uv;
-
-            // Inside of rim.
-            vertices[vertexCount + i].position =
-              math::float4(center.x, center.y) + math::float4(x, y, 0, 0) * innerRadius;
-            vertices[vertexCount + i].color = math::float4(1, 1, 1, 1);
-            vertices[vertexCount + i].uv    = uvInner;
-
-            // Outside of triangle fan.
-            vertices[vertexCount * 2 + i].position =
-              math::float4(center.x, center.y) + math::float4(x, y, 0, 0) * innerRadius;
-            vertices[vertexCount * 2 + i].color = math::float4(1, 1, 1, 1);
-            vertices[vertexCount * 2 + i].uv    = uvInner;
-        }
+        if (maxChordError <= 0) return vertexCount;
+        if (maxChordError >= radius) return min_segments;
 
-        // Center vertex.
-        vertices.back().position = math::float4(center.x, center.y);
-        vertices.back().color    = 1;
-        vertices.back().uv       = 0.5f;
+        // The largest distance between a chord and the arc it spans is radius * (1 - cos(angle / 2)).
+        const auto angle = 2.0f * std::acos(1.0f - maxChordError / radius);
+        const auto count = static_cast<uint32_t>(std::ceil(2.0f * math::m_pi / angle));
+        return std::clamp((count + segment_step - 1) / segment_step * segment_step, min_segments, max_segments);
+    }
 
-        for (uint32_t i = 0; i < vertexCount - 1; i++)
-        {
-            // Quad of rim.
-            indices[i * 6 + 0] = i;
-            indices[i * 6 + 1] = i + 1;
-            indices[i * 6 + 2] = vertexCount + i;
-            indices[i * 6 + 3] = i + 1;
-            indices[i * 6 + 4] = vertexCount + i;
-            indices[i * 6 + 5] = vertexCount + i + 1;
-
-            // Triangle of fan.
-            indices[vertexCount * 6 + i * 3 + 0] = vertexCount * 2 + i;
-            indices[vertexCount * 6 + i * 3 + 1] = vertexCount * 2 + i + 1;
-            indices[vertexCount * 6 + i * 3 + 2] = vertexCount * 3;
-        }
+    ////////////////////////////////////////////////////////////////
+    // Generate.
+    ////////////////////////////////////////////////////////////////
 
-        // Last quad and triangle wrap around.
-        indices[(vertexCount - 1) * 6 + 0] = vertexCount - 1;
-        indices[(vertexCount - 1) * 6 + 1] = 0;
-        indices[(vertexCount - 1) * 6 + 2] = vertexCount;
-        indices[(vertexCount - 1) * 6 + 3] = vertexCount - 1;
-        indices[(vertexCount - 1) * 6 + 4] = vertexCount * 2 - 1;
-        indices[(vertexCount - 1) * 6 + 5] = vertexCount;
-        indices[vertexCount * 9 - 3]       = vertexCount * 2;
-        indices[vertexCount * 9 - 2]       = vertexCount * 3 - 1;
-        indices[vertexCount * 9 - 1]       = vertexCount * 3;
+    sol::IMesh& CircleGenerator::generate(Params& params)
+    {
+        // Circle will consist of an outer rim of quads and an inner triangle fan.
+        const auto                 count    = getSegmentCount();
+        auto*                      resource = getScratchResource(params);
+        std::pmr::vector<Vertex>   vertices(count * 3 + 1, resource);
+        std::pmr::vector<uint32_t> indices(count * 3 * 3, 0, resource);
+        writeVertices(vertices.data(), count);
+        writeRimIndices(indices.data(), count, 0);
+        writeFanIndices(indices.data() + count * 6, count, 0);
 
         // We generate a description that contains all data, even if e.g. fill is disabled. Makes updating a lot easier.
         auto desc = params.meshManager.createMeshDescription();
         desc->addVertexBuffer(sizeof(Vertex), static_cast<uint32_t>(vertices.size()));
         desc->setVertexData(0, 0, vertices.size(), vertices.data());
-        desc->addIndexBuffer(sizeof(uint32_t), static_cast<uint32_t>(indices.size()));
-        desc->setIndexData(0, indices.size(), indices.data());
+        addIndexData(*desc, indices, vertices.size(), resource);
 
-        // Create mesh and set indices based on fillMode.
-        auto& mesh = params.meshManager.createIndexedMesh(std::move(desc));
-        if (fillMode == FillMode::Outline) { mesh.setIndexCount(vertexCount * 6); }
-        else if (fillMode == FillMode::Fill)
+        // Update mesh in place. Index ranges only change with fillMode or segment count.
+        if (params.mesh)
         {
-            mesh.setFirstIndex(vertexCount * 6);
-            mesh.setIndexCount(vertexCount * 3);
+            auto* indexedMesh = dynamic_cast<sol::IndexedMesh*>(params.mesh);
+            if (!indexedMesh) throw FloahError("CircleGenerator can only update an IndexedMesh.");
+
+            indexedMesh->update(std::move(desc));
+            if (indexedMesh != mesh || fillMode != meshFillMode || count != meshVertexCount)
+                setIndexRange(*indexedMesh, count);
+            return *indexedMesh;
         }
 
-        return mesh;
+        // Create mesh and set indices based on fillMode.
+        auto& newMesh = params.meshManager.createIndexedMesh(std::move(desc));
+        setIndexRange(newMesh, count);
+        return newMesh;
 #if 0
         const auto hMargin   = static_cast<float>(margin.get(static_cast<int32_t>(upper.x - lower.x)));
         const auto vMargin   = static_cast<float>(margin.get(static_cast<int32_t>(upper.y - lower.y)));
@@ -173,4 +196,204 @@ namespace floah
         return mesh;
 #endif
     }
+
+    Generator::Counts CircleGenerator::measure()
+    {
+        const auto count = getSegmentCount();
+        if (fillMode == FillMode::Outline) return {count * 3 + 1, count * 6};
+        if (fillMode == FillMode::Fill) return {count * 3 + 1, count * 3};
+        return {count * 3 + 1, count * 9};
+    }
+
+    void CircleGenerator::emit(FontMap&,
+                               const std::span<Vertex>   vertices,
+                               const std::span<uint32_t> indices,
+                               const uint32_t            firstVertex)
+    {
+        emitGeometry(vertices, indices, firstVertex);
+    }
+
+    void CircleGenerator::emit(FontMap&,
+                               const std::span<CompactVertex> vertices,
+                               const std::span<uint32_t>      indices,
+                               const uint32_t                 firstVertex)
+    {
+        emitGeometry(vertices, indices, firstVertex);
+    }
+
+    template<typename V>
+    void CircleGenerator::emitGeometry(const std::span<V>        vertices,
+                                       const std::span<uint32_t> indices,
+                                       const uint32_t            firstVertex)
+    {
+        const auto count = getSegmentCount();
+        writeVertices(vertices.data(), count);
+
+        // Only write indices that are drawn.
+        if (fillMode == FillMode::Outline)
+            writeRimIndices(indices.data(), count, firstVertex);
+        else if (fillMode == FillMode::Fill)
+            writeFanIndices(indices.data(), count, firstVertex);
+        else
+        {
+            writeRimIndices(indices.data(), count, firstVertex);
+            writeFanIndices(indices.data() + count * 6, count, firstVertex);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Instancing.
+    ////////////////////////////////////////////////////////////////
+
+    sol::IndexedMesh& CircleGenerator::createUnitMesh(sol::MeshManager& meshManager, const uint32_t vertexCount)
+    {
+        if (vertexCount < 3) throw FloahError("Cannot create a unit circle with less than 3 vertices.");
+
+        // Unit meshes are created once per vertex count, so there is no need to share the table.
+        std::vector<math::float2> table;
+        std::vector<Vertex>       vertices(vertexCount * 3 + 1);
+        std::vector<uint32_t>     indices(vertexCount * 9);
+        computeUnitCircle(table, vertexCount);
+        for (uint32_t i = 0; i < vertexCount; i++)
+        {
+            const float x  = table[i].x;
+            const float y  = table[i].y;
+            const auto  uv = math::float2(x, y) * 0.5f + 0.5f;
+
+            // Outside of rim, inside of rim and outside of triangle fan.
+            vertices[i]                   = {math::float4(x, y, 0, 1), math::float4(1, 1, 1, 1), uv};
+            vertices[vertexCount + i]     = {math::float4(x, y, 1, 1), math::float4(1, 1, 1, 1), uv};
+            vertices[vertexCount * 2 + i] = {math::float4(x, y, 1, 2), math::float4(1, 1, 1, 1), uv};
+        }
+
+        // Center vertex.
+        vertices.back() = {math::float4(0, 0, 1, 2), math::float4(1, 1, 1, 1), math::float2(0.5f, 0.5f)};
+        writeRimIndices(indices.data(), vertexCount, 0);
+        writeFanIndices(indices.data() + vertexCount * 6, vertexCount, 0);
+
+        auto desc = meshManager.createMeshDescription();
+        desc->addVertexBuffer(sizeof(Vertex), static_cast<uint32_t>(vertices.size()));
+        desc->setVertexData(0, 0, vertices.size(), vertices.data());
+        addIndexData(*desc, indices, vertices.size());
+        return meshManager.createIndexedMesh(std::move(desc));
+    }
+
+    void CircleGenerator::appendInstance(std::vector<ShapeInstance>& instances) const
+    {
+        const auto outline = static_cast<float>(margin.get(static_cast<int32_t>(radius)));
+
+        auto& instance    = instances.emplace_back();
+        instance.bounds   = {center.x - radius, center.y - radius, center.x + radius, center.y + radius};
+        instance.margin   = {outline, outline};
+        instance.color    = packColor(math::float4(1, 1, 1, 1));
+        instance.fillMode = static_cast<uint32_t>(fillMode);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Generate.
+    ////////////////////////////////////////////////////////////////
+
+    template<typename V>
+    void CircleGenerator::writeVertices(V* vertices, const uint32_t count)
+    {
+        using Traits            = VertexTraits<V>;
+        const auto& table       = getUnitCircle(count);
+        const auto  innerRadius = radius - static_cast<float>(margin.get(static_cast<int32_t>(radius)));
+        const auto  rel         = innerRadius / radius;
+        const auto  white       = math::float4(1, 1, 1, 1);
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const float x       = table[i].x;
+            const float y       = table[i].y;
+            const auto  uv      = math::float2(x, y) * 0.5f + 0.5f;
+            const auto  uvInner = uv * rel;
+            const auto  outer   = math::float2(center.x + x * radius, center.y + y * radius);
+            const auto  inner   = math::float2(center.x + x * innerRadius, center.y + y * innerRadius);
+
+            // Outside of rim, inside of rim and outside of triangle fan.
+            vertices[i]             = Traits::create(outer, white, uv);
+            vertices[count + i]     = Traits::create(inner, white, uvInner);
+            vertices[count * 2 + i] = Traits::create(inner, white, uvInner);
+        }
+
+        // Center vertex.
+        vertices[count * 3] = Traits::create(center, white, math::float2(0.5f, 0.5f));
+    }
+
+    const std::vector<math::float2>& CircleGenerator::getUnitCircle(const uint32_t count)
+    {
+        if (unitCircle && count == unitCircleCount) return *unitCircle;
+
+        // Counts above max_segments can only come from an explicit vertexCount and are not shared.
+        if (count <= max_segments)
+            unitCircle = &getSharedUnitCircle(count);
+        else
+        {
+            computeUnitCircle(ownedUnitCircle, count);
+            unitCircle = &ownedUnitCircle;
+        }
+
+        unitCircleCount = count;
+        return *unitCircle;
+    }
+
+    void CircleGenerator::writeRimIndices(uint32_t* indices, const uint32_t vertexCount, const uint32_t base)
+    {
+        for (uint32_t i = 0; i < vertexCount - 1; i++)
+        {
+            indices[i * 6 + 0] = base + i;
+            indices[i * 6 + 1] = base + i + 1;
+            indices[i * 6 + 2] = base + vertexCount + i;
+            indices[i * 6 + 3] = base + i + 1;
+            indices[i * 6 + 4] = base + vertexCount + i;
+            indices[i * 6 + 5] = base + vertexCount + i + 1;
+        }
+
+        // Last quad wraps around.
+        indices[(vertexCount - 1) * 6 + 0] = base + vertexCount - 1;
+        indices[(vertexCount - 1) * 6 + 1] = base + 0;
+        indices[(vertexCount - 1) * 6 + 2] = base + vertexCount;
+        indices[(vertexCount - 1) * 6 + 3] = base + vertexCount - 1;
+        indices[(vertexCount - 1) * 6 + 4] = base + vertexCount * 2 - 1;
+        indices[(vertexCount - 1) * 6 + 5] = base + vertexCount;
+    }
+
+    void CircleGenerator::writeFanIndices(uint32_t* indices, const uint32_t vertexCount, const uint32_t base)
+    {
+        for (uint32_t i = 0; i < vertexCount - 1; i++)
+        {
+            indices[i * 3 + 0] = base + vertexCount * 2 + i;
+            indices[i * 3 + 1] = base + vertexCount * 2 + i + 1;
+            indices[i * 3 + 2] = base + vertexCount * 3;
+        }
+
+        // Last triangle wraps around.
+        indices[vertexCount * 3 - 3] = base + vertexCount * 2;
+        indices[vertexCount * 3 - 2] = base + vertexCount * 3 - 1;
+        indices[vertexCount * 3 - 1] = base + vertexCount * 3;
+    }
+
+    void CircleGenerator::setIndexRange(sol::IndexedMesh& indexedMesh, const uint32_t count)
+    {
+        if (fillMode == FillMode::Outline)
+        {
+            indexedMesh.setFirstIndex(0);
+            indexedMesh.setIndexCount(count * 6);
+        }
+        else if (fillMode == FillMode::Fill)
+        {
+            indexedMesh.setFirstIndex(count * 6);
+            indexedMesh.setIndexCount(count * 3);
+        }
+        else
+        {
+            indexedMesh.setFirstIndex(0);
+            indexedMesh.setIndexCount(count * 9);
+        }
+
+        mesh            = &indexedMesh;
+        meshFillMode    = fillMode;
+        meshVertexCount = count;
+    }
 }  // namespace floah
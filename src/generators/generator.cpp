@@ -0,0 +1,29 @@
+#include "floah-viz/generators/generator.h"
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-common/floah_error.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Generate.
+    ////////////////////////////////////////////////////////////////
+
+    void Generator::emit(FontMap&, std::span<ShapeVertex>, std::span<uint32_t>, uint32_t)
+    {
+        throw FloahError("Generator does not support ShapeVertex geometry.");
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Scratch memory.
+    ////////////////////////////////////////////////////////////////
+
+    std::pmr::memory_resource* Generator::getScratchResource(const Params& params) noexcept
+    {
+        if (params.arena) return params.arena;
+        return std::pmr::get_default_resource();
+    }
+}  // namespace floah
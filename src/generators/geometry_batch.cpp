@@ -0,0 +1,296 @@
+#include "floah-viz/generators/geometry_batch.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <format>
+#include <span>
+#include <utility>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-common/floah_error.h"
+#include "sol/mesh/indexed_mesh.h"
+#include "sol/mesh/mesh_description.h"
+#include "sol/mesh/mesh_manager.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/index_data.h"
+
+namespace
+{
+    /**
+     * \brief Grow a capacity by 1.5x, or more if required.
+     * \param required Required capacity.
+     * \param capacity Current capacity.
+     * \return New capacity.
+     */
+    uint32_t grow(const uint32_t required, const uint32_t capacity)
+    {
+        return std::max(required, capacity + capacity / 2);
+    }
+}  // namespace
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    template<typename V>
+    BasicGeometryBatch<V>::BasicGeometryBatch() = default;
+
+    template<typename V>
+    BasicGeometryBatch<V>::BasicGeometryBatch(BasicGeometryBatch&&) noexcept = default;
+
+    template<typename V>
+    BasicGeometryBatch<V>::~BasicGeometryBatch() noexcept = default;
+
+    template<typename V>
+    BasicGeometryBatch<V>& BasicGeometryBatch<V>::operator=(BasicGeometryBatch&&) noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    template<typename V>
+    uint32_t BasicGeometryBatch<V>::getItemCount() const noexcept
+    {
+        return static_cast<uint32_t>(items.size() - freeHandles.size());
+    }
+
+    template<typename V>
+    const std::vector<V>& BasicGeometryBatch<V>::getVertices() const noexcept { return vertices; }
+
+    template<typename V>
+    const std::vector<uint32_t>& BasicGeometryBatch<V>::getIndices() const noexcept { return indices; }
+
+    template<typename V>
+    uint32_t BasicGeometryBatch<V>::getUnusedVertexCount() const noexcept
+    {
+        return static_cast<uint32_t>(vertices.size()) - usedVertexCount;
+    }
+
+    template<typename V>
+    typename BasicGeometryBatch<V>::Range BasicGeometryBatch<V>::getRange(const Handle handle) const
+    {
+        const auto& item = getItem(handle);
+        return {item.firstVertex, item.vertexCount, item.firstIndex, item.indexCount};
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Items.
+    ////////////////////////////////////////////////////////////////
+
+    template<typename V>
+    typename BasicGeometryBatch<V>::Handle BasicGeometryBatch<V>::add(Generator& generator, FontMap& fontMap)
+    {
+        Item item{.alive = true};
+        write(item, generator, fontMap, false);
+
+        // Reuse handle of a removed item.
+        Handle handle;
+        if (freeHandles.empty())
+        {
+            handle = static_cast<Handle>(items.size());
+            items.emplace_back();
+        }
+        else
+        {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+        }
+
+        items[handle] = item;
+        return handle;
+    }
+
+    template<typename V>
+    void BasicGeometryBatch<V>::update(const Handle handle, Generator& generator, FontMap& fontMap)
+    {
+        write(getItem(handle), generator, fontMap, true);
+    }
+
+    template<typename V>
+    void BasicGeometryBatch<V>::remove(const Handle handle)
+    {
+        auto& item = getItem(handle);
+        collapse(item);
+        usedVertexCount -= item.vertexCount;
+        item = Item{};
+        freeHandles.emplace_back(handle);
+    }
+
+    template<typename V>
+    void BasicGeometryBatch<V>::clear() noexcept
+    {
+        items.clear();
+        freeHandles.clear();
+        vertices.clear();
+        indices.clear();
+        usedVertexCount = 0;
+    }
+
+    template<typename V>
+    void BasicGeometryBatch<V>::compact()
+    {
+        // Move all live items to the front, in order of their current position.
+        std::vector<Handle> order;
+        order.reserve(items.size());
+        for (Handle i = 0; i < items.size(); i++)
+            if (items[i].alive) order.emplace_back(i);
+        std::ranges::sort(order, {}, [&](const Handle h) { return items[h].firstVertex; });
+
+        uint32_t vertexEnd = 0, indexEnd = 0;
+        for (const auto h : order)
+        {
+            auto& item = items[h];
+            std::copy_n(vertices.begin() + item.firstVertex, item.vertexCount, vertices.begin() + vertexEnd);
+            for (uint32_t i = 0; i < item.indexCount; i++)
+                indices[indexEnd + i] = indices[item.firstIndex + i] - item.firstVertex + vertexEnd;
+
+            item.firstVertex    = vertexEnd;
+            item.vertexCapacity = item.vertexCount;
+            item.firstIndex     = indexEnd;
+            item.indexCapacity  = item.indexCount;
+            vertexEnd += item.vertexCount;
+            indexEnd += item.indexCount;
+        }
+
+        vertices.resize(vertexEnd);
+        indices.resize(indexEnd);
+    }
+
+    template<typename V>
+    typename BasicGeometryBatch<V>::Item& BasicGeometryBatch<V>::getItem(const Handle handle)
+    {
+        return const_cast<Item&>(std::as_const(*this).getItem(handle));
+    }
+
+    template<typename V>
+    const typename BasicGeometryBatch<V>::Item& BasicGeometryBatch<V>::getItem(const Handle handle) const
+    {
+        if (handle >= items.size() || !items[handle].alive)
+            throw FloahError(std::format("GeometryBatch does not contain an item with handle {}.", handle));
+        return items[handle];
+    }
+
+    template<typename V>
+    void BasicGeometryBatch<V>::write(Item& item, Generator& generator, FontMap& fontMap, const bool slack)
+    {
+        const auto [vertexCount, indexCount] = generator.measure();
+
+        // Reserve a new sub-range at the end of the lists if the geometry does not fit.
+        auto       target         = item;
+        const auto relocate       = vertexCount > item.vertexCapacity || indexCount > item.indexCapacity;
+        const auto oldVertexCount = vertices.size();
+        const auto oldIndexCount  = indices.size();
+        if (relocate)
+        {
+            target.firstVertex    = static_cast<uint32_t>(oldVertexCount);
+            target.firstIndex     = static_cast<uint32_t>(oldIndexCount);
+            target.vertexCapacity = slack ? grow(vertexCount, item.vertexCapacity) : vertexCount;
+            target.indexCapacity  = slack ? grow(indexCount, item.indexCapacity) : indexCount;
+
+            // Keep whole triangles, so that sub-ranges stay aligned.
+            target.indexCapacity -= target.indexCapacity % 3;
+        }
+
+        // Emit straight into the lists.
+        try
+        {
+            if (relocate)
+            {
+                vertices.resize(oldVertexCount + target.vertexCapacity);
+                indices.resize(oldIndexCount + target.indexCapacity, target.firstVertex);
+            }
+
+            generator.emit(fontMap,
+                           std::span(vertices).subspan(target.firstVertex, vertexCount),
+                           std::span(indices).subspan(target.firstIndex, indexCount),
+                           target.firstVertex);
+        }
+        catch (...)
+        {
+            // Drop the new sub-range, leaving the item as it was. When writing in place, part of the old geometry may
+            // already be overwritten, so the item is left empty instead.
+            if (relocate)
+            {
+                vertices.resize(oldVertexCount);
+                indices.resize(oldIndexCount);
+            }
+            else
+            {
+                collapse(item);
+                usedVertexCount -= item.vertexCount;
+                item.vertexCount = 0;
+                item.indexCount  = 0;
+            }
+            throw;
+        }
+
+        // Collapse the remaining capacity.
+        const auto vertexIt = vertices.begin() + target.firstVertex;
+        const auto indexIt  = indices.begin() + target.firstIndex;
+        std::fill(vertexIt + vertexCount, vertexIt + target.vertexCapacity, V{});
+        std::fill(indexIt + indexCount, indexIt + target.indexCapacity, target.firstVertex);
+
+        // Only release the old sub-range once the new geometry was written.
+        if (relocate) collapse(item);
+
+        usedVertexCount += vertexCount;
+        usedVertexCount -= item.vertexCount;
+        item             = target;
+        item.vertexCount = vertexCount;
+        item.indexCount  = indexCount;
+    }
+
+    template<typename V>
+    void BasicGeometryBatch<V>::collapse(const Item& item)
+    {
+        const auto vertexIt = vertices.begin() + item.firstVertex;
+        const auto indexIt  = indices.begin() + item.firstIndex;
+        std::fill(vertexIt, vertexIt + item.vertexCapacity, V{});
+        std::fill(indexIt, indexIt + item.indexCapacity, item.firstVertex);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Generate.
+    ////////////////////////////////////////////////////////////////
+
+    template<typename V>
+    sol::IMesh& BasicGeometryBatch<V>::generate(sol::MeshManager& meshManager, sol::IMesh* mesh)
+    {
+        if (indices.empty()) throw FloahError("Cannot generate a mesh for an empty GeometryBatch.");
+
+        auto desc = meshManager.createMeshDescription();
+        desc->addVertexBuffer(sizeof(V), static_cast<uint32_t>(vertices.size()));
+        desc->setVertexData(0, 0, vertices.size(), vertices.data());
+        addIndexData(*desc, indices, vertices.size());
+
+        // Update mesh in place. The index count changes whenever items are added or relocated.
+        if (mesh)
+        {
+            auto* indexedMesh = dynamic_cast<sol::IndexedMesh*>(mesh);
+            if (!indexedMesh) throw FloahError("GeometryBatch can only update an IndexedMesh.");
+
+            indexedMesh->update(std::move(desc));
+            indexedMesh->setFirstIndex(0);
+            indexedMesh->setIndexCount(static_cast<uint32_t>(indices.size()));
+            return *indexedMesh;
+        }
+
+        return meshManager.createIndexedMesh(std::move(desc));
+    }
+
+    template class BasicGeometryBatch<Vertex>;
+    template class BasicGeometryBatch<CompactVertex>;
+    template class BasicGeometryBatch<ShapeVertex>;
+}  // namespace floah
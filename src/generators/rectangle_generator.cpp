@@ -1,10 +1,17 @@
 #include "floah-viz/generators/rectangle_generator.h"
 
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <array>
+
 ////////////////////////////////////////////////////////////////
 // Module includes.
 ////////////////////////////////////////////////////////////////
 
 #include "common/enum_classes.h"
+#include "floah-common/floah_error.h"
 #include "sol/mesh/indexed_mesh.h"
 #include "sol/mesh/mesh_description.h"
 #include "sol/mesh/mesh_manager.h"
@@ -13,8 +20,18 @@
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "floah-viz/index_data.h"
 #include "floah-viz/vertex.h"
 
+namespace
+{
+    /**
+     * \brief Outline quads followed by the two fill triangles.
+     */
+    constexpr std::array<uint32_t, 30> rectangle_indices = {0, 1, 4, 1, 5, 4, 1, 2, 5, 2, 6, 5, 2, 3, 6,
+                                                            3, 7, 6, 0, 4, 7, 0, 7, 3, 4, 5, 7, 5, 6, 7};
+}  // namespace
+
 namespace floah
 {
     ////////////////////////////////////////////////////////////////
@@ -31,62 +48,147 @@ namespace floah
 
     sol::IMesh& RectangleGenerator::generate(Params& params)
     {
-        if (params.mesh) throw std::runtime_error("Update not yet implemented");
+        std::array<Vertex, 8> vertices;
+        writeVertices(vertices.data());
 
+        // We generate a description that contains all data, even if e.g. fill is disabled. Makes updating a lot easier.
+        auto desc = params.meshManager.createMeshDescription();
+        desc->addVertexBuffer(sizeof(Vertex), static_cast<uint32_t>(vertices.size()));
+        desc->setVertexData(0, 0, vertices.size(), vertices.data());
+        addIndexData(*desc, rectangle_indices, vertices.size(), getScratchResource(params));
+
+        // Update mesh in place. Index data never changes, only the drawn range does.
+        if (params.mesh)
+        {
+            auto* indexedMesh = dynamic_cast<sol::IndexedMesh*>(params.mesh);
+            if (!indexedMesh) throw FloahError("RectangleGenerator can only update an IndexedMesh.");
+
+            indexedMesh->update(std::move(desc));
+            if (indexedMesh != mesh || fillMode != meshFillMode) setIndexRange(*indexedMesh);
+            return *indexedMesh;
+        }
+
+        // Create mesh and set indices based on fillMode.
+        auto& newMesh = params.meshManager.createIndexedMesh(std::move(desc));
+        setIndexRange(newMesh);
+        return newMesh;
+    }
+
+    Generator::Counts RectangleGenerator::measure()
+    {
+        return {8, getIndexRange().second};
+    }
+
+    void RectangleGenerator::emit(FontMap&,
+                                  const std::span<Vertex>   vertices,
+                                  const std::span<uint32_t> indices,
+                                  const uint32_t            firstVertex)
+    {
+        emitGeometry(vertices, indices, firstVertex);
+    }
+
+    void RectangleGenerator::emit(FontMap&,
+                                  const std::span<CompactVertex> vertices,
+                                  const std::span<uint32_t>      indices,
+                                  const uint32_t                 firstVertex)
+    {
+        emitGeometry(vertices, indices, firstVertex);
+    }
+
+    template<typename V>
+    void RectangleGenerator::emitGeometry(const std::span<V>        vertices,
+                                          const std::span<uint32_t> indices,
+                                          const uint32_t            firstVertex) const
+    {
+        writeVertices(vertices.data());
+
+        // Only write indices that are drawn.
+        const auto [first, count] = getIndexRange();
+        for (uint32_t i = 0; i < count; i++) indices[i] = firstVertex + rectangle_indices[first + i];
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Instancing.
+    ////////////////////////////////////////////////////////////////
+
+    sol::IndexedMesh& RectangleGenerator::createUnitMesh(sol::MeshManager& meshManager)
+    {
+        // Outline quads use the outer and inner corners. The fill quad gets its own copy of the inner corners, so that
+        // outline and fill can be collapsed independently.
+        constexpr std::array<std::array<float, 2>, 4> corners = {{{0, 0}, {0, 1}, {1, 1}, {1, 0}}};
+        std::array<Vertex, 12>                        vertices;
+        for (size_t i = 0; i < corners.size(); i++)
+        {
+            const auto [x, y] = corners[i];
+            vertices[i]       = {math::float4(x, y, 0, 1), math::float4(1, 1, 1, 1), math::float2(x, y)};
+            vertices[i + 4]   = {math::float4(x, y, 1, 1), math::float4(1, 1, 1, 1), math::float2(x, y)};
+            vertices[i + 8]   = {math::float4(x, y, 1, 2), math::float4(1, 1, 1, 1), math::float2(x, y)};
+        }
+
+        auto indices = rectangle_indices;
+        for (size_t i = 24; i < indices.size(); i++) indices[i] += 4;
+
+        auto desc = meshManager.createMeshDescription();
+        desc->addVertexBuffer(sizeof(Vertex), static_cast<uint32_t>(vertices.size()));
+        desc->setVertexData(0, 0, vertices.size(), vertices.data());
+        addIndexData(*desc, indices, vertices.size());
+        return meshManager.createIndexedMesh(std::move(desc));
+    }
+
+    void RectangleGenerator::appendInstance(std::vector<ShapeInstance>& instances) const
+    {
+        auto& instance    = instances.emplace_back();
+        instance.bounds   = {lower.x, lower.y, upper.x, upper.y};
+        instance.margin   = {static_cast<float>(margin.get(static_cast<int32_t>(upper.x - lower.x))),
+                             static_cast<float>(margin.get(static_cast<int32_t>(upper.y - lower.y)))};
+        instance.color    = packColor(color);
+        instance.fillMode = static_cast<uint32_t>(fillMode);
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Generate.
+    ////////////////////////////////////////////////////////////////
+
+    template<typename V>
+    void RectangleGenerator::writeVertices(V* vertices) const
+    {
+        using Traits         = VertexTraits<V>;
         const auto hMargin   = static_cast<float>(margin.get(static_cast<int32_t>(upper.x - lower.x)));
         const auto vMargin   = static_cast<float>(margin.get(static_cast<int32_t>(upper.y - lower.y)));
         const auto hUvMargin = hMargin / (upper.x - lower.x);
         const auto vUvMargin = vMargin / (upper.y - lower.y);
 
-        std::array<Vertex, 8> vertices;
-
         // Outer quad vertices.
-        vertices[0].position = math::float4(lower.x, lower.y, 0, 0);
-        vertices[0].color    = color;
-        vertices[0].uv       = math::float2(0, 0);
-        vertices[1].position = math::float4(lower.x, upper.y, 0, 0);
-        vertices[1].color    = color;
-        vertices[1].uv       = math::float2(0, 1);
-        vertices[2].position = math::float4(upper.x, upper.y, 0, 0);
-        vertices[2].color    = color;
-        vertices[2].uv       = math::float2(1, 1);
-        vertices[3].position = math::float4(upper.x, lower.y, 0, 0);
-        vertices[3].color    = color;
-        vertices[3].uv       = math::float2(1, 0);
+        vertices[0] = Traits::create(math::float2(lower.x, lower.y), color, math::float2(0, 0));
+        vertices[1] = Traits::create(math::float2(lower.x, upper.y), color, math::float2(0, 1));
+        vertices[2] = Traits::create(math::float2(upper.x, upper.y), color, math::float2(1, 1));
+        vertices[3] = Traits::create(math::float2(upper.x, lower.y), color, math::float2(1, 0));
 
         // Inner quad vertices.
-        vertices[4].position = math::float4(lower.x + hMargin, lower.y + vMargin, 0, 0);
-        vertices[4].color    = color;
-        vertices[4].uv       = math::float2(hUvMargin, vUvMargin);
-        vertices[5].position = math::float4(lower.x + hMargin, upper.y - vMargin, 0, 0);
-        vertices[5].color    = color;
-        vertices[5].uv       = math::float2(hUvMargin, 1 - vUvMargin);
-        vertices[6].position = math::float4(upper.x - hMargin, upper.y - vMargin, 0, 0);
-        vertices[6].color    = color;
-        vertices[6].uv       = math::float2(1 - hUvMargin, 1 - vUvMargin);
-        vertices[7].position = math::float4(upper.x - hMargin, lower.y + vMargin, 0, 0);
-        vertices[7].color    = color;
-        vertices[7].uv       = math::float2(1 - hUvMargin, vUvMargin);
-
-        constexpr std::array<uint32_t, 30> indices = {0, 1, 4, 1, 5, 4, 1, 2, 5, 2, 6, 5, 2, 3, 6,
-                                                      3, 7, 6, 0, 4, 7, 0, 7, 3, 4, 5, 7, 5, 6, 7};
+        vertices[4] = Traits::create(
+          math::float2(lower.x + hMargin, lower.y + vMargin), color, math::float2(hUvMargin, vUvMargin));
+        vertices[5] = Traits::create(
+          math::float2(lower.x + hMargin, upper.y - vMargin), color, math::float2(hUvMargin, 1 - vUvMargin));
+        vertices[6] = Traits::create(
+          math::float2(upper.x - hMargin, upper.y - vMargin), color, math::float2(1 - hUvMargin, 1 - vUvMargin));
+        vertices[7] = Traits::create(
+          math::float2(upper.x - hMargin, lower.y + vMargin), color, math::float2(1 - hUvMargin, vUvMargin));
+    }
 
-        // We generate a description that contains all data, even if e.g. fill is disabled. Makes updating a lot easier.
-        auto desc = params.meshManager.createMeshDescription();
-        desc->addVertexBuffer(sizeof(Vertex), static_cast<uint32_t>(vertices.size()));
-        desc->setVertexData(0, 0, vertices.size(), vertices.data());
-        desc->addIndexBuffer(sizeof(uint32_t), static_cast<uint32_t>(indices.size()));
-        desc->setIndexData(0, indices.size(), indices.data());
+    std::pair<uint32_t, uint32_t> RectangleGenerator::getIndexRange() const noexcept
+    {
+        if (fillMode == FillMode::Outline) return {0, 24};
+        if (fillMode == FillMode::Fill) return {24, 6};
+        return {0, 30};
+    }
 
-        // Create mesh and set indices based on fillMode.
-        auto& mesh = params.meshManager.createIndexedMesh(std::move(desc));
-        if (fillMode == FillMode::Outline) { mesh.setIndexCount(24); }
-        else if (fillMode == FillMode::Fill)
-        {
-            mesh.setFirstIndex(24);
-            mesh.setIndexCount(6);
-        }
+    void RectangleGenerator::setIndexRange(sol::IndexedMesh& indexedMesh)
+    {
+        const auto [first, count] = getIndexRange();
+        indexedMesh.setFirstIndex(first);
+        indexedMesh.setIndexCount(count);
 
-        return mesh;
+        mesh         = &indexedMesh;
+        meshFillMode = fillMode;
     }
 }  // namespace floah
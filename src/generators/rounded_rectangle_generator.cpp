@@ -0,0 +1,146 @@
+#include "floah-viz/generators/rounded_rectangle_generator.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-common/floah_error.h"
+#include "sol/mesh/indexed_mesh.h"
+#include "sol/mesh/mesh_description.h"
+#include "sol/mesh/mesh_manager.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/index_data.h"
+
+namespace
+{
+    /**
+     * \brief Number of pixels the quad extends beyond the shape, so that the edge can be antialiased.
+     */
+    constexpr float aa_padding = 1.0f;
+
+    constexpr std::array<uint32_t, 6> quad_indices = {0, 1, 2, 0, 2, 3};
+}  // namespace
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    RoundedRectangleGenerator::RoundedRectangleGenerator() = default;
+
+    RoundedRectangleGenerator::~RoundedRectangleGenerator() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    float RoundedRectangleGenerator::getDistance(const math::float2 point) const
+    {
+        const auto halfWidth  = (upper.x - lower.x) * 0.5f;
+        const auto halfHeight = (upper.y - lower.y) * 0.5f;
+        const auto radius     = std::clamp(cornerRadius, 0.0f, std::min(halfWidth, halfHeight));
+
+        // Distance to a rectangle shrunk by the corner radius, minus the radius.
+        const auto qx = std::abs(point.x - (lower.x + halfWidth)) - halfWidth + radius;
+        const auto qy = std::abs(point.y - (lower.y + halfHeight)) - halfHeight + radius;
+        const auto d  = std::hypot(std::max(qx, 0.0f), std::max(qy, 0.0f)) + std::min(std::max(qx, qy), 0.0f) - radius;
+
+        // Outline is a band of outlineWidth on the inside of the edge.
+        const auto outlineWidth = getOutlineWidth();
+        if (outlineWidth > 0) return std::abs(d + outlineWidth * 0.5f) - outlineWidth * 0.5f;
+        return d;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Generate.
+    ////////////////////////////////////////////////////////////////
+
+    sol::IMesh& RoundedRectangleGenerator::generate(Params& params)
+    {
+        std::array<ShapeVertex, 4> vertices;
+        writeVertices(vertices.data());
+
+        auto desc = params.meshManager.createMeshDescription();
+        desc->addVertexBuffer(sizeof(ShapeVertex), static_cast<uint32_t>(vertices.size()));
+        desc->setVertexData(0, 0, vertices.size(), vertices.data());
+        addIndexData(*desc, quad_indices, vertices.size(), getScratchResource(params));
+
+        // Update mesh.
+        if (params.mesh)
+        {
+            params.mesh->update(std::move(desc));
+            return *params.mesh;
+        }
+
+        // Create new mesh.
+        return params.meshManager.createIndexedMesh(std::move(desc));
+    }
+
+    Generator::Counts RoundedRectangleGenerator::measure()
+    {
+        return {4, static_cast<uint32_t>(quad_indices.size())};
+    }
+
+    void RoundedRectangleGenerator::emit(FontMap&, std::span<Vertex>, std::span<uint32_t>, uint32_t)
+    {
+        throw FloahError("RoundedRectangleGenerator can only emit ShapeVertex geometry.");
+    }
+
+    void RoundedRectangleGenerator::emit(FontMap&, std::span<CompactVertex>, std::span<uint32_t>, uint32_t)
+    {
+        throw FloahError("RoundedRectangleGenerator can only emit ShapeVertex geometry.");
+    }
+
+    void RoundedRectangleGenerator::emit(FontMap&,
+                                         const std::span<ShapeVertex> vertices,
+                                         const std::span<uint32_t>    indices,
+                                         const uint32_t               firstVertex)
+    {
+        writeVertices(vertices.data());
+        for (size_t i = 0; i < quad_indices.size(); i++) indices[i] = firstVertex + quad_indices[i];
+    }
+
+    void RoundedRectangleGenerator::writeVertices(ShapeVertex* vertices) const
+    {
+        const auto halfSize     = math::float2((upper.x - lower.x) * 0.5f, (upper.y - lower.y) * 0.5f);
+        const auto center       = math::float2(lower.x + halfSize.x, lower.y + halfSize.y);
+        const auto radius       = std::clamp(cornerRadius, 0.0f, std::min(halfSize.x, halfSize.y));
+        const auto outlineWidth = getOutlineWidth();
+
+        // Quad corners, padded for antialiasing.
+        const std::array<math::float2, 4> corners = {math::float2(lower.x - aa_padding, lower.y - aa_padding),
+                                                     math::float2(upper.x + aa_padding, lower.y - aa_padding),
+                                                     math::float2(upper.x + aa_padding, upper.y + aa_padding),
+                                                     math::float2(lower.x - aa_padding, upper.y + aa_padding)};
+
+        for (size_t i = 0; i < corners.size(); i++)
+        {
+            vertices[i].position     = corners[i];
+            vertices[i].local        = math::float2(corners[i].x - center.x, corners[i].y - center.y);
+            vertices[i].halfSize     = halfSize;
+            vertices[i].cornerRadius = radius;
+            vertices[i].outlineWidth = outlineWidth;
+            vertices[i].color        = color;
+        }
+    }
+
+    float RoundedRectangleGenerator::getOutlineWidth() const
+    {
+        if (fillMode != FillMode::Outline) return 0;
+        const auto reference = std::min(upper.x - lower.x, upper.y - lower.y) * 0.5f;
+        return static_cast<float>(margin.get(static_cast<int32_t>(reference)));
+    }
+}  // namespace floah
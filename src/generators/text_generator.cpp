@@ -1,10 +1,20 @@
 #include "floah-viz/generators/text_generator.h"
 
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 ////////////////////////////////////////////////////////////////
 // External includes.
 ////////////////////////////////////////////////////////////////
 
-#include "unicode/unistr.h"
+#include "unicode/utf8.h"
 
 ////////////////////////////////////////////////////////////////
 // Module includes.
@@ -19,7 +29,103 @@
 // Current target includes.
 ////////////////////////////////////////////////////////////////
 
+#include "floah-viz/index_data.h"
 #include "floah-viz/vertex.h"
+#include "text_quads.h"
+
+namespace
+{
+    /**
+     * \brief Write the indices of a run of quads into a pre-sized buffer. Each quad is drawn as 2 triangles with the
+     * pattern {0, 1, 2, 0, 2, 3}.
+     * \param out Output indices, count * 6.
+     * \param firstVertex Index of the first vertex of the first quad.
+     * \param count Number of quads.
+     */
+    void writeQuadIndices(uint32_t* out, const uint32_t firstVertex, const uint32_t count)
+    {
+        uint32_t i = 0;
+
+#if defined(__AVX2__)
+        // 4 quads produce 24 indices, written as 3 vectors of 8.
+        {
+            const auto a    = _mm256_setr_epi32(0, 1, 2, 0, 2, 3, 4, 5);
+            const auto b    = _mm256_setr_epi32(6, 4, 6, 7, 8, 9, 10, 8);
+            const auto c    = _mm256_setr_epi32(10, 11, 12, 13, 14, 12, 14, 15);
+            const auto step = _mm256_set1_epi32(16);
+            auto       base = _mm256_set1_epi32(static_cast<int32_t>(firstVertex));
+            for (; i + 4 <= count; i += 4, base = _mm256_add_epi32(base, step))
+            {
+                auto* dst = reinterpret_cast<__m256i*>(out + static_cast<size_t>(i) * 6);
+                _mm256_storeu_si256(dst + 0, _mm256_add_epi32(base, a));
+                _mm256_storeu_si256(dst + 1, _mm256_add_epi32(base, b));
+                _mm256_storeu_si256(dst + 2, _mm256_add_epi32(base, c));
+            }
+        }
+#endif
+
+#if defined(__SSE2__)
+        // 2 quads produce 12 indices, written as 3 vectors of 4.
+        {
+            const auto a    = _mm_setr_epi32(0, 1, 2, 0);
+            const auto b    = _mm_setr_epi32(2, 3, 4, 5);
+            const auto c    = _mm_setr_epi32(6, 4, 6, 7);
+            const auto step = _mm_set1_epi32(8);
+            auto       base = _mm_set1_epi32(static_cast<int32_t>(firstVertex + i * 4));
+            for (; i + 2 <= count; i += 2, base = _mm_add_epi32(base, step))
+            {
+                auto* dst = reinterpret_cast<__m128i*>(out + static_cast<size_t>(i) * 6);
+                _mm_storeu_si128(dst + 0, _mm_add_epi32(base, a));
+                _mm_storeu_si128(dst + 1, _mm_add_epi32(base, b));
+                _mm_storeu_si128(dst + 2, _mm_add_epi32(base, c));
+            }
+        }
+#endif
+
+        // Remaining quads.
+        for (; i < count; i++)
+        {
+            const auto v = firstVertex + i * 4;
+            auto*      o = out + static_cast<size_t>(i) * 6;
+            o[0]         = v;
+            o[1]         = v + 1;
+            o[2]         = v + 2;
+            o[3]         = v;
+            o[4]         = v + 2;
+            o[5]         = v + 3;
+        }
+    }
+
+    /**
+     * \brief Decode UTF-8 in a single pass, skipping ill-formed sequences.
+     * \param text Text.
+     * \param codes Output character codes.
+     */
+    void decodeText(const std::string& text, std::vector<uint32_t>& codes)
+    {
+        codes.clear();
+        const auto* str    = reinterpret_cast<const uint8_t*>(text.data());
+        const auto  length = static_cast<int32_t>(text.size());
+        for (int32_t i = 0; i < length;)
+        {
+            UChar32 c;
+            U8_NEXT(str, i, length, c);
+            if (c >= 0) codes.emplace_back(static_cast<uint32_t>(c));
+        }
+    }
+
+    /**
+     * \brief Get the factor by which character metrics must be scaled to render at a font size.
+     * \param fontMap FontMap.
+     * \param fontSize Font size, or 0 for the em size.
+     * \return Scale.
+     */
+    float calculateScale(const floah::FontMap& fontMap, const float fontSize)
+    {
+        const auto emSize = static_cast<float>(fontMap.getEmSize());
+        return fontSize > 0 && emSize > 0 ? fontSize / emSize : 1.0f;
+    }
+}  // namespace
 
 namespace floah
 {
@@ -31,75 +137,207 @@ namespace floah
 
     TextGenerator::~TextGenerator() noexcept = default;
 
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    std::pair<uint32_t, uint32_t> TextGenerator::getUpdatedVertexRange() const noexcept { return updatedVertexRange; }
+
+    uint64_t TextGenerator::getGeneration() const noexcept { return generation; }
+
     ////////////////////////////////////////////////////////////////
     // Generate.
     ////////////////////////////////////////////////////////////////
 
     sol::IMesh& TextGenerator::generate(Params& params)
     {
-        const icu::UnicodeString ustr(text.c_str());
-        std::vector<Vertex>      vertices;
-        std::vector<uint32_t>    indices;
-        math::float2             offset = position;
+        decodeText(text, nextCodes);
+
+        // Scale metrics from the size the FontMap was rasterized at to the requested size.
+        const auto scale    = calculateScale(params.fontMap, fontSize);
+        const auto ascender = static_cast<float>(params.fontMap.getFontAscender());
+
+        // Previous glyphs can only be reused when updating the same mesh with the same layout parameters. Read the
+        // generation before acquiring any characters, which may evict others.
+        const auto startGeneration = params.fontMap.getGeneration();
+        const auto oldCount        = static_cast<uint32_t>(codes.size());
+        const auto newCount        = static_cast<uint32_t>(nextCodes.size());
+        const bool reuse           = params.mesh && params.mesh == mesh && &params.fontMap == fontMap &&
+                                     position.x == layoutPosition.x && position.y == layoutPosition.y &&
+                                     scale == layoutScale && generation == startGeneration;
+
+        // Find unchanged glyphs at the start and end of the text.
+        uint32_t prefix = 0, suffix = 0;
+        if (reuse)
+        {
+            while (prefix < std::min(oldCount, newCount) && codes[prefix] == nextCodes[prefix]) prefix++;
+            while (suffix < std::min(oldCount, newCount) - prefix &&
+                   codes[oldCount - 1 - suffix] == nextCodes[newCount - 1 - suffix])
+                suffix++;
+
+            // Mark the reused glyphs as recently used, so that acquiring the changed glyphs does not evict them.
+            if (params.fontMap.isDynamic())
+            {
+                for (uint32_t i = 0; i < prefix; i++) static_cast<void>(params.fontMap.acquireCharacter(nextCodes[i]));
+                for (uint32_t i = newCount - suffix; i < newCount; i++)
+                    static_cast<void>(params.fontMap.acquireCharacter(nextCodes[i]));
+            }
+        }
+        else
+            pens.assign(1, position.x);
+
+        // Grow buffers with some slack, so that small changes in length do not require reallocating the mesh.
+        const bool grow = newCount > capacity;
+        if (grow)
+        {
+            const auto oldCapacity = capacity;
+            capacity               = std::max(newCount, capacity + capacity / 2);
+            vertices.resize(static_cast<size_t>(capacity) * 4);
+            indices.resize(static_cast<size_t>(capacity) * 6);
+            writeQuadIndices(
+              indices.data() + static_cast<size_t>(oldCapacity) * 6, oldCapacity * 4, capacity - oldCapacity);
+        }
+
+        // Move unchanged glyphs at the end to their new position.
+        const auto oldMiddleEnd = oldCount - suffix;
+        const auto newMiddleEnd = newCount - suffix;
+        if (suffix > 0 && oldMiddleEnd != newMiddleEnd)
+        {
+            const auto first = vertices.begin() + static_cast<ptrdiff_t>(oldMiddleEnd) * 4;
+            const auto last  = vertices.begin() + static_cast<ptrdiff_t>(oldCount) * 4;
+            if (newMiddleEnd < oldMiddleEnd)
+                std::copy(first, last, vertices.begin() + static_cast<ptrdiff_t>(newMiddleEnd) * 4);
+            else
+                std::copy_backward(first, last, vertices.begin() + static_cast<ptrdiff_t>(newCount) * 4);
+        }
+
+        // Same for the pen positions after each of those glyphs.
+        float oldSuffixPen = 0;
+        if (suffix > 0)
+        {
+            oldSuffixPen = pens[oldMiddleEnd];
+            pens.resize(std::max(oldCount, newCount) + 1);
+            const auto first = pens.begin() + oldMiddleEnd + 1;
+            const auto last  = pens.begin() + oldCount + 1;
+            if (newCount < oldCount)
+                std::copy(first, last, pens.begin() + newMiddleEnd + 1);
+            else
+                std::copy_backward(first, last, pens.begin() + newCount + 1);
+        }
+        pens.resize(newCount + 1);
 
-        for (int32_t i = 0; i < ustr.countChar32(); i++)
+        // Look up changed glyphs and lay them out, then generate their quads in one go.
+        math::float2 pen(pens[prefix], position.y);
+        glyphs.clear();
+        for (uint32_t i = prefix; i < newMiddleEnd; i++)
         {
-            // Get current character metrics.
-            const auto& character = params.fontMap.getCharacter(static_cast<uint32_t>(ustr.char32At(i)));
-
-            // Base position and size.
-            math::float2 p = offset;
-            p.x += static_cast<float>(character.bearing.x);
-            p.y += static_cast<float>(character.size.y) - static_cast<float>(character.bearing.y);
-            p.y += static_cast<float>(params.fontMap.getFontAscender() - character.size.y);
-            const auto s = math::float2(character.size);
-
-            // Quad vertices.
-            Vertex v;
-            v.position = math::float4(p.x, p.y, 0.0f, 0.0f);
-            v.color    = math::float4(1.0f);
-            v.uv       = character.uv0;
-            vertices.emplace_back(v);
-            v.position = math::float4(p.x + s.x, p.y, 0.0f, 0.0f);
-            v.color    = math::float4(1.0f);
-            v.uv       = math::float2(character.uv1.x, character.uv0.y);
-            vertices.emplace_back(v);
-            v.position = math::float4(p.x + s.x, p.y + s.y, 0.0f, 0.0f);
-            v.color    = math::float4(1.0f);
-            v.uv       = character.uv1;
-            vertices.emplace_back(v);
-            v.position = math::float4(p.x, p.y + s.y, 0.0f, 0.0f);
-            v.color    = math::float4(1.0f);
-            v.uv       = math::float2(character.uv0.x, character.uv1.y);
-            vertices.emplace_back(v);
-
-            // Two tris.
-            indices.emplace_back(i * 4 + 0);
-            indices.emplace_back(i * 4 + 1);
-            indices.emplace_back(i * 4 + 2);
-            indices.emplace_back(i * 4 + 0);
-            indices.emplace_back(i * 4 + 2);
-            indices.emplace_back(i * 4 + 3);
-
-            offset.x += static_cast<float>(character.advance >> 6);
+            const auto& character = glyphs.emplace_back(params.fontMap.acquireCharacter(nextCodes[i]));
+            pen.x += static_cast<float>(character.advance >> 6) * scale;
+            pens[i + 1] = pen.x;
         }
+        detail::writeQuads(glyphs.data(),
+                           pens.data() + prefix,
+                           glyphs.size(),
+                           position.y,
+                           ascender,
+                           scale,
+                           vertices.data() + static_cast<size_t>(prefix) * 4);
+
+        // Acquiring the changed glyphs still evicted characters, which may include reused ones. Discard the previous
+        // state, so that the call below regenerates all glyphs.
+        if (reuse && params.fontMap.getGeneration() != startGeneration)
+        {
+            mesh = nullptr;
+            return generate(params);
+        }
+
+        // Shift unchanged glyphs at the end if the changed glyphs have a different total advance.
+        const auto delta = suffix > 0 ? pen.x - oldSuffixPen : 0.0f;
+        if (delta != 0.0f)
+        {
+            for (uint32_t i = newMiddleEnd + 1; i <= newCount; i++) pens[i] += delta;
+            for (uint32_t i = newMiddleEnd * 4; i < newCount * 4; i++) vertices[i].position.x += delta;
+        }
+
+        // Collapse unused quads so that they are not rasterized.
+        for (uint32_t i = newCount * 4; i < std::min(oldCount, capacity) * 4; i++) vertices[i] = Vertex{};
+
+        // Determine which vertices were written.
+        const auto end     = delta == 0.0f && oldCount == newCount ? newMiddleEnd : std::max(oldCount, newCount);
+        updatedVertexRange = grow || !reuse ? std::make_pair(0u, capacity * 4) : std::make_pair(prefix * 4, end * 4);
+
+        codes.swap(nextCodes);
+        fontMap        = &params.fontMap;
+        layoutPosition = position;
+        layoutScale    = scale;
+        generation     = params.fontMap.getGeneration();
 
         // Create mesh description.
         auto desc = params.meshManager.createMeshDescription();
         desc->addVertexBuffer(sizeof(Vertex), static_cast<uint32_t>(vertices.size()));
         desc->setVertexData(0, 0, vertices.size(), vertices.data());
-        desc->addIndexBuffer(sizeof(uint32_t), static_cast<uint32_t>(indices.size()));
-        desc->setIndexData(0, indices.size(), indices.data());
+        addIndexData(*desc, indices, vertices.size(), getScratchResource(params));
 
         // Update mesh.
         if (params.mesh)
         {
             params.mesh->update(std::move(desc));
+            mesh = params.mesh;
             return *params.mesh;
         }
 
         // Create new mesh.
-        auto& mesh = params.meshManager.createIndexedMesh(std::move(desc));
-        return mesh;
+        mesh = &params.meshManager.createIndexedMesh(std::move(desc));
+        return *mesh;
+    }
+
+    Generator::Counts TextGenerator::measure()
+    {
+        decodeText(text, nextCodes);
+        const auto count = static_cast<uint32_t>(nextCodes.size());
+        return {count * 4, count * 6};
+    }
+
+    void TextGenerator::emit(FontMap&                  targetFontMap,
+                             const std::span<Vertex>   outVertices,
+                             const std::span<uint32_t> outIndices,
+                             const uint32_t            firstVertex)
+    {
+        emitGeometry(targetFontMap, outVertices, outIndices, firstVertex);
+    }
+
+    void TextGenerator::emit(FontMap&                       targetFontMap,
+                             const std::span<CompactVertex> outVertices,
+                             const std::span<uint32_t>      outIndices,
+                             const uint32_t                 firstVertex)
+    {
+        emitGeometry(targetFontMap, outVertices, outIndices, firstVertex);
+    }
+
+    template<typename V>
+    void TextGenerator::emitGeometry(FontMap&                  targetFontMap,
+                                     const std::span<V>        outVertices,
+                                     const std::span<uint32_t> outIndices,
+                                     const uint32_t            firstVertex)
+    {
+        decodeText(text, nextCodes);
+
+        const auto scale    = calculateScale(targetFontMap, fontSize);
+        const auto ascender = static_cast<float>(targetFontMap.getFontAscender());
+        const auto count    = static_cast<uint32_t>(nextCodes.size());
+
+        // Look up all glyphs and lay them out.
+        glyphs.clear();
+        glyphPens.clear();
+        float pen = position.x;
+        for (const auto code : nextCodes)
+        {
+            const auto& character = glyphs.emplace_back(targetFontMap.acquireCharacter(code));
+            glyphPens.emplace_back(pen);
+            pen += static_cast<float>(character.advance >> 6) * scale;
+        }
+
+        detail::writeQuads(glyphs.data(), glyphPens.data(), count, position.y, ascender, scale, outVertices.data());
+        writeQuadIndices(outIndices.data(), firstVertex, count);
     }
 }  // namespace floah
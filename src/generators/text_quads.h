@@ -0,0 +1,178 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "math/include_all.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/font_map.h"
+#include "floah-viz/vertex.h"
+
+/*
+ * Kernels that write the vertices of glyph quads. Internal to floah-viz; in a header only so that the benchmarks can
+ * compare the scalar and vectorized paths.
+ */
+
+namespace floah::detail
+{
+    /**
+     * \brief Write the vertices of a run of glyph quads into a pre-sized buffer, one vertex at a time.
+     * \tparam V Vertex type.
+     * \param characters Character metrics of each glyph.
+     * \param pens Horizontal pen position before each glyph.
+     * \param count Number of glyphs.
+     * \param y Vertical pen position.
+     * \param ascender Font ascender.
+     * \param scale Metrics scale.
+     * \param out Output vertices, count * 4.
+     */
+    template<typename V>
+    void writeQuadsScalar(const FontMap::Character* characters,
+                          const float*              pens,
+                          const size_t              count,
+                          const float               y,
+                          const float               ascender,
+                          const float               scale,
+                          V*                        out)
+    {
+        using Traits     = VertexTraits<V>;
+        const auto white = math::float4(1.0f);
+
+        for (size_t i = 0; i < count; i++, out += 4)
+        {
+            const auto& c = characters[i];
+
+            // Corners.
+            const auto x0 = pens[i] + static_cast<float>(c.bearing.x) * scale;
+            const auto y0 = y + (ascender - static_cast<float>(c.bearing.y)) * scale;
+            const auto x1 = x0 + static_cast<float>(c.size.x) * scale;
+            const auto y1 = y0 + static_cast<float>(c.size.y) * scale;
+
+            // Quad vertices.
+            out[0] = Traits::create(math::float2(x0, y0), white, c.uv0);
+            out[1] = Traits::create(math::float2(x1, y0), white, math::float2(c.uv1.x, c.uv0.y));
+            out[2] = Traits::create(math::float2(x1, y1), white, c.uv1);
+            out[3] = Traits::create(math::float2(x0, y1), white, math::float2(c.uv0.x, c.uv1.y));
+        }
+    }
+
+#if defined(__SSE2__)
+    /**
+     * \brief Write the compact vertices of a run of glyph quads with SSE2. Each glyph is computed as a single vector
+     * of corners {x0, y0, x1, y1} and a single vector of texture coordinates, which are packed and shuffled into the 4
+     * vertices. Produces the same values as writeQuadsScalar, including the rounding of packUnorm16. Only when the
+     * compiler contracts multiply-adds into FMA instructions can positions differ in the last bit.
+     * \param characters Character metrics of each glyph.
+     * \param pens Horizontal pen position before each glyph.
+     * \param count Number of glyphs.
+     * \param y Vertical pen position.
+     * \param ascender Font ascender.
+     * \param scale Metrics scale.
+     * \param out Output vertices, count * 4.
+     */
+    inline void writeQuadsSse2(const FontMap::Character* characters,
+                               const float*              pens,
+                               const size_t              count,
+                               const float               y,
+                               const float               ascender,
+                               const float               scale,
+                               CompactVertex*            out)
+    {
+        const auto white  = _mm_set1_epi32(static_cast<int32_t>(packColor(math::float4(1.0f))));
+        const auto scales = _mm_set1_ps(scale);
+        const auto zero   = _mm_setzero_ps();
+        const auto one    = _mm_set1_ps(1.0f);
+        const auto max16  = _mm_set1_ps(65535.0f);
+        const auto half   = _mm_set1_ps(0.5f);
+        const auto bias   = _mm_set1_epi32(0x8000);
+        const auto bias16 = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+
+        for (size_t i = 0; i < count; i++, out += 4)
+        {
+            const auto& c = characters[i];
+
+            // Corners. The first add gives {x0, y0, w, h}, the second adds {x0, y0} to the upper half.
+            const auto metrics = _mm_setr_ps(static_cast<float>(c.bearing.x),
+                                             ascender - static_cast<float>(c.bearing.y),
+                                             static_cast<float>(c.size.x),
+                                             static_cast<float>(c.size.y));
+            const auto origin  = _mm_add_ps(_mm_setr_ps(pens[i], y, 0, 0), _mm_mul_ps(metrics, scales));
+            const auto corners = _mm_castps_si128(_mm_add_ps(origin, _mm_movelh_ps(zero, origin)));
+
+            // Texture coordinates {u0, v0, u1, v1}, clamped and scaled to unorm16. Round half away from zero like
+            // lround: truncate, then add 1 when the fraction is at least 0.5. The mask of cmpge is -1.
+            const auto uv        = _mm_setr_ps(c.uv0.x, c.uv0.y, c.uv1.x, c.uv1.y);
+            const auto scaled    = _mm_mul_ps(_mm_min_ps(_mm_max_ps(uv, zero), one), max16);
+            const auto truncated = _mm_cvttps_epi32(scaled);
+            const auto fraction  = _mm_sub_ps(scaled, _mm_cvtepi32_ps(truncated));
+            const auto rounded   = _mm_sub_epi32(truncated, _mm_castps_si128(_mm_cmpge_ps(fraction, half)));
+
+            // Pack to 16 bits. SSE2 only has a signed pack, so shift the range to signed and back.
+            const auto uv16 = _mm_add_epi16(_mm_packs_epi32(_mm_sub_epi32(rounded, bias), _mm_setzero_si128()), bias16);
+
+            // Select {0, 1, 2, 1} and {2, 3, 0, 3} of the corners as 32-bit lanes and of the texture coordinates as
+            // 16-bit lanes, giving the (x, y) and (u, v) pairs of vertices 0, 1 and 2, 3.
+            const auto p01 = _mm_shuffle_epi32(corners, _MM_SHUFFLE(1, 2, 1, 0));
+            const auto p23 = _mm_shuffle_epi32(corners, _MM_SHUFFLE(3, 0, 3, 2));
+            const auto t   = _mm_unpacklo_epi64(_mm_shufflelo_epi16(uv16, _MM_SHUFFLE(1, 2, 1, 0)),
+                                              _mm_shufflelo_epi16(uv16, _MM_SHUFFLE(3, 0, 3, 2)));
+            const auto c01 = _mm_unpacklo_epi32(white, t);
+            const auto c23 = _mm_unpackhi_epi32(white, t);
+
+            // Quad vertices, each {x, y, color, uv}.
+            auto* dst = reinterpret_cast<__m128i*>(out);
+            _mm_storeu_si128(dst + 0, _mm_unpacklo_epi64(p01, c01));
+            _mm_storeu_si128(dst + 1, _mm_unpackhi_epi64(p01, c01));
+            _mm_storeu_si128(dst + 2, _mm_unpacklo_epi64(p23, c23));
+            _mm_storeu_si128(dst + 3, _mm_unpackhi_epi64(p23, c23));
+        }
+    }
+#endif
+
+    /**
+     * \brief Write the vertices of a run of glyph quads into a pre-sized buffer. Uses writeQuadsSse2 for compact
+     * vertices when available.
+     * \tparam V Vertex type.
+     * \param characters Character metrics of each glyph.
+     * \param pens Horizontal pen position before each glyph.
+     * \param count Number of glyphs.
+     * \param y Vertical pen position.
+     * \param ascender Font ascender.
+     * \param scale Metrics scale.
+     * \param out Output vertices, count * 4.
+     */
+    template<typename V>
+    void writeQuads(const FontMap::Character* characters,
+                    const float*              pens,
+                    const size_t              count,
+                    const float               y,
+                    const float               ascender,
+                    const float               scale,
+                    V*                        out)
+    {
+#if defined(__SSE2__)
+        if constexpr (std::is_same_v<V, CompactVertex>)
+        {
+            writeQuadsSse2(characters, pens, count, y, ascender, scale, out);
+            return;
+        }
+#endif
+        writeQuadsScalar(characters, pens, count, y, ascender, scale, out);
+    }
+}  // namespace floah::detail
@@ -0,0 +1,45 @@
+#include "floah-viz/index_data.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "sol/mesh/mesh_description.h"
+
+namespace floah
+{
+    size_t getIndexSize(const size_t vertexCount) noexcept
+    {
+        // Every vertex index must fit, i.e. the highest index is vertexCount - 1.
+        if (vertexCount <= static_cast<size_t>(std::numeric_limits<uint16_t>::max()) + 1) return sizeof(uint16_t);
+        return sizeof(uint32_t);
+    }
+
+    void addIndexData(sol::MeshDescription&            desc,
+                      const std::span<const uint32_t>  indices,
+                      const size_t                     vertexCount,
+                      std::pmr::memory_resource* const resource)
+    {
+        const auto count = static_cast<uint32_t>(indices.size());
+        if (getIndexSize(vertexCount) == sizeof(uint32_t))
+        {
+            desc.addIndexBuffer(sizeof(uint32_t), count);
+            desc.setIndexData(0, indices.size(), indices.data());
+            return;
+        }
+
+        std::pmr::vector<uint16_t> shortIndices(indices.size(), resource);
+        std::ranges::transform(
+          indices, shortIndices.begin(), [](const uint32_t i) { return static_cast<uint16_t>(i); });
+        desc.addIndexBuffer(sizeof(uint16_t), count);
+        desc.setIndexData(0, shortIndices.size(), shortIndices.data());
+    }
+}  // namespace floah
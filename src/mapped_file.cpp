@@ -0,0 +1,134 @@
+#include "floah-viz/mapped_file.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <format>
+#include <utility>
+
+////////////////////////////////////////////////////////////////
+// External includes.
+////////////////////////////////////////////////////////////////
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-common/floah_error.h"
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    MappedFile::MappedFile() = default;
+
+    MappedFile::MappedFile(const std::filesystem::path& filePath)
+    {
+#ifdef _WIN32
+        const auto file = CreateFileW(filePath.c_str(),
+                                      GENERIC_READ,
+                                      FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                      nullptr,
+                                      OPEN_EXISTING,
+                                      FILE_ATTRIBUTE_NORMAL,
+                                      nullptr);
+        if (file == INVALID_HANDLE_VALUE) throw FloahError(std::format("Failed to open file {}.", filePath.string()));
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize))
+        {
+            CloseHandle(file);
+            throw FloahError(std::format("Failed to get size of file {}.", filePath.string()));
+        }
+
+        // Mapping an empty file is not allowed.
+        if (fileSize.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) throw FloahError(std::format("Failed to map file {}.", filePath.string()));
+
+        // View keeps the mapping alive.
+        const auto* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!view) throw FloahError(std::format("Failed to map file {}.", filePath.string()));
+
+        data = static_cast<const uint8_t*>(view);
+        size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        const auto fd = open(filePath.c_str(), O_RDONLY);
+        if (fd == -1) throw FloahError(std::format("Failed to open file {}.", filePath.string()));
+
+        struct stat st;
+        if (fstat(fd, &st) == -1)
+        {
+            close(fd);
+            throw FloahError(std::format("Failed to get size of file {}.", filePath.string()));
+        }
+
+        // Mapping an empty file is not allowed.
+        if (st.st_size == 0)
+        {
+            close(fd);
+            return;
+        }
+
+        // Mapping stays valid after closing the descriptor.
+        auto* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (view == MAP_FAILED) throw FloahError(std::format("Failed to map file {}.", filePath.string()));
+
+        data = static_cast<const uint8_t*>(view);
+        size = static_cast<size_t>(st.st_size);
+#endif
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept :
+        data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0))
+    {
+    }
+
+    MappedFile::~MappedFile() noexcept
+    {
+        if (!data) return;
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+#else
+        munmap(const_cast<uint8_t*>(data), size);
+#endif
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            std::swap(data, other.data);
+            std::swap(size, other.size);
+        }
+        return *this;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    std::span<const uint8_t> MappedFile::getData() const noexcept { return {data, size}; }
+}  // namespace floah
@@ -0,0 +1,101 @@
+#include "floah-viz/style_tracker.h"
+
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+namespace floah
+{
+    ////////////////////////////////////////////////////////////////
+    // Constructors.
+    ////////////////////////////////////////////////////////////////
+
+    StyleTracker::StyleTracker() = default;
+
+    StyleTracker::~StyleTracker() noexcept = default;
+
+    ////////////////////////////////////////////////////////////////
+    // Getters.
+    ////////////////////////////////////////////////////////////////
+
+    const std::vector<StyleTracker::Dependent>& StyleTracker::getDirty() const noexcept { return dirty; }
+
+    bool StyleTracker::isDirty(const Dependent dependent) const noexcept { return dirtySet.find(dependent) != nullptr; }
+
+    ////////////////////////////////////////////////////////////////
+    // Setters.
+    ////////////////////////////////////////////////////////////////
+
+    void StyleTracker::subscribe(const Dependent dependent, const Stylesheet& stylesheet, const uint64_t key)
+    {
+        auto& list = subscriptions.tryEmplace(key);
+        const auto it = std::ranges::find_if(
+          list, [&](const Subscription& s) { return s.dependent == dependent && s.stylesheet == &stylesheet; });
+        if (it == list.end()) list.emplace_back(dependent, &stylesheet);
+    }
+
+    void StyleTracker::unsubscribe(const Dependent dependent)
+    {
+        subscriptions.forEach([&](uint64_t, std::vector<Subscription>& list) {
+            std::erase_if(list, [&](const Subscription& s) { return s.dependent == dependent; });
+        });
+    }
+
+    void StyleTracker::clearDirty() noexcept
+    {
+        dirty.clear();
+        dirtySet.clear();
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Notify.
+    ////////////////////////////////////////////////////////////////
+
+    void StyleTracker::notify(const Stylesheet& changed, const uint64_t key)
+    {
+        const auto* list = subscriptions.find(key);
+        if (!list) return;
+
+        for (const auto& subscription : *list)
+        {
+            // Walk up the chain. A stylesheet between the subscribed and the changed one hides the changed value.
+            for (const auto* sheet = subscription.stylesheet; sheet; sheet = sheet->getParent())
+            {
+                if (sheet == &changed)
+                {
+                    markDirty(subscription.dependent);
+                    break;
+                }
+                if (sheet->contains(key)) break;
+            }
+        }
+    }
+
+    void StyleTracker::notifyAll(const Stylesheet& changed)
+    {
+        subscriptions.forEach([&](uint64_t, const std::vector<Subscription>& list) {
+            for (const auto& subscription : list)
+            {
+                for (const auto* sheet = subscription.stylesheet; sheet; sheet = sheet->getParent())
+                {
+                    if (sheet != &changed) continue;
+                    markDirty(subscription.dependent);
+                    break;
+                }
+            }
+        });
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // Dirty.
+    ////////////////////////////////////////////////////////////////
+
+    void StyleTracker::markDirty(const Dependent dependent)
+    {
+        if (dirtySet.find(dependent)) return;
+        dirtySet.insertOrAssign(dependent, true);
+        dirty.emplace_back(dependent);
+    }
+}  // namespace floah
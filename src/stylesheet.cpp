@@ -1,26 +1,109 @@
 #include "floah-viz/stylesheet.h"
 
+////////////////////////////////////////////////////////////////
+// Standard includes.
+////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <format>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+////////////////////////////////////////////////////////////////
+// Module includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-common/floah_error.h"
+
+////////////////////////////////////////////////////////////////
+// Current target includes.
+////////////////////////////////////////////////////////////////
+
+#include "floah-viz/style_tracker.h"
+
 namespace floah
 {
+    ////////////////////////////////////////////////////////////////
+    // PropertyId.
+    ////////////////////////////////////////////////////////////////
+
+    void PropertyId::registerName([[maybe_unused]] const std::string_view name, [[maybe_unused]] const uint32_t hash)
+    {
+#ifndef NDEBUG
+        static std::mutex                                mutex;
+        static std::unordered_map<uint32_t, std::string> names;
+
+        std::scoped_lock lock(mutex);
+        const auto [it, inserted] = names.try_emplace(hash, name);
+        if (!inserted && it->second != name)
+            throw FloahError(
+              std::format(R"(Property names "{}" and "{}" have the same hash {:#010x}.)", it->second, name, hash));
+#endif
+    }
+
     ////////////////////////////////////////////////////////////////
     // Constructors.
     ////////////////////////////////////////////////////////////////
 
     Stylesheet::Stylesheet() = default;
 
-    Stylesheet::Stylesheet(const Stylesheet& other) { *this = other; }
+    Stylesheet::Stylesheet(const Stylesheet& other) :
+        maps(other.maps),
+        packed(other.packed),
+        packedOverrides(other.packedOverrides),
+        parent(other.parent),
+        tracker(other.tracker)
+    {
+        // A new stylesheet has no dependents yet, so there is no need to notify the tracker.
+        other.overrides.forEach(
+          [this](const uint32_t key, const BaseMapPtr& map) { overrides.tryEmplace(key, map->clone()); });
+    }
 
-    Stylesheet::Stylesheet(Stylesheet&&) noexcept = default;
+    Stylesheet::Stylesheet(Stylesheet&& other) noexcept :
+        maps(std::move(other.maps)),
+        overrides(std::move(other.overrides)),
+        packed(std::move(other.packed)),
+        packedOverrides(std::move(other.packedOverrides)),
+        parent(other.parent),
+        tracker(other.tracker)
+    {
+        other.version = nextVersion();
+    }
 
     Stylesheet::~Stylesheet() noexcept = default;
 
     Stylesheet& Stylesheet::operator=(const Stylesheet& other)
     {
-        for (const auto& [k, v] : other.maps) maps.try_emplace(k, v->clone());
+        if (this == &other) return *this;
+
+        // Share the maps and only copy the overrides, which are expected to be small.
+        maps = other.maps;
+        overrides.clear();
+        other.overrides.forEach(
+          [this](const uint32_t key, const BaseMapPtr& map) { overrides.tryEmplace(key, map->clone()); });
+        packed          = other.packed;
+        packedOverrides = other.packedOverrides;
+        parent          = other.parent;
+        tracker         = other.tracker;
+        version         = nextVersion();
+        if (tracker) tracker->notifyAll(*this);
         return *this;
     }
 
-    Stylesheet& Stylesheet::operator=(Stylesheet&&) noexcept = default;
+    Stylesheet& Stylesheet::operator=(Stylesheet&& other) noexcept
+    {
+        maps          = std::move(other.maps);
+        overrides       = std::move(other.overrides);
+        packed          = std::move(other.packed);
+        packedOverrides = std::move(other.packedOverrides);
+        parent          = other.parent;
+        tracker         = other.tracker;
+        version         = nextVersion();
+        other.version   = nextVersion();
+        if (tracker) tracker->notifyAll(*this);
+        return *this;
+    }
 
     ////////////////////////////////////////////////////////////////
     // Getters.
@@ -30,10 +113,106 @@ namespace floah
 
     const Stylesheet* Stylesheet::getParent() const noexcept { return parent; }
 
+    uint64_t Stylesheet::getVersion() const noexcept { return version; }
+
+    StyleTracker* Stylesheet::getTracker() const noexcept { return tracker; }
+
+    bool Stylesheet::contains(const uint64_t key) const noexcept
+    {
+        if (packedOverrides.offsets.find(key) || (packed && packed->offsets.find(key))) return true;
+
+        const auto type = static_cast<uint32_t>(key >> 32);
+        const auto id   = static_cast<uint32_t>(key);
+        if (const auto* map = overrides.find(type); map && (*map)->contains(id)) return true;
+        if (const auto* map = maps.find(type); map && (*map)->contains(id)) return true;
+        return false;
+    }
+
     ////////////////////////////////////////////////////////////////
     // Setters.
     ////////////////////////////////////////////////////////////////
 
-    void Stylesheet::setParent(Stylesheet* stylesheet) noexcept { parent = stylesheet; }
+    void Stylesheet::setParent(Stylesheet* stylesheet)
+    {
+        parent  = stylesheet;
+        version = nextVersion();
+        if (!tracker && parent) tracker = parent->tracker;
+        if (tracker) tracker->notifyAll(*this);
+    }
+
+    void Stylesheet::setTracker(StyleTracker* styleTracker) noexcept { tracker = styleTracker; }
 
+    ////////////////////////////////////////////////////////////////
+    // Maps.
+    ////////////////////////////////////////////////////////////////
+
+    void Stylesheet::PackedValues::flatten(ValueTable& table) const
+    {
+        offsets.forEach(
+          [&](const uint64_t key, const uint32_t offset) { table.tryEmplace(key, data.data() + offset); });
+    }
+
+    Stylesheet::PackedValues& Stylesheet::getWritablePackedValues(const uint64_t key)
+    {
+        if (packedOverrides.offsets.find(key)) return packedOverrides;
+        if (!packed) packed = std::make_shared<PackedValues>();
+        if (packed.use_count() == 1) return *packed;
+        return packedOverrides;
+    }
+
+    void Stylesheet::notifyTracker(const uint64_t key) { tracker->notify(*this, key); }
+
+    uint64_t Stylesheet::nextVersion() noexcept
+    {
+        static std::atomic<uint64_t> counter = 0;
+        return ++counter;
+    }
+
+    ////////////////////////////////////////////////////////////////
+    // FlattenedStylesheet.
+    ////////////////////////////////////////////////////////////////
+
+    FlattenedStylesheet::FlattenedStylesheet(const Stylesheet& sheet) : stylesheet(&sheet) {}
+
+    FlattenedStylesheet::FlattenedStylesheet(FlattenedStylesheet&&) noexcept = default;
+
+    FlattenedStylesheet::~FlattenedStylesheet() noexcept = default;
+
+    FlattenedStylesheet& FlattenedStylesheet::operator=(FlattenedStylesheet&&) noexcept = default;
+
+    const Stylesheet& FlattenedStylesheet::getStylesheet() const noexcept { return *stylesheet; }
+
+    bool FlattenedStylesheet::isValid() const noexcept
+    {
+        if (chain.empty()) return false;
+
+        const auto* sheet = stylesheet;
+        for (const auto& [s, v] : chain)
+        {
+            if (sheet != s || sheet->version != v) return false;
+            sheet = sheet->parent;
+        }
+
+        return true;
+    }
+
+    void FlattenedStylesheet::update()
+    {
+        table.clear();
+        chain.clear();
+        resolved.clear();
+
+        // Walk from the stylesheet up, so that values closest to it are added first and hide those of ancestors. Within
+        // a stylesheet, overrides hide shared values.
+        for (const auto* sheet = stylesheet; sheet; sheet = sheet->parent)
+        {
+            chain.emplace_back(sheet, sheet->version);
+            sheet->packedOverrides.flatten(table);
+            sheet->overrides.forEach(
+              [this](const uint32_t type, const Stylesheet::BaseMapPtr& map) { map->flatten(type, table); });
+            if (sheet->packed) sheet->packed->flatten(table);
+            sheet->maps.forEach(
+              [this](const uint32_t type, const Stylesheet::SharedMapPtr& map) { map->flatten(type, table); });
+        }
+    }
 }  // namespace floah